@@ -0,0 +1,40 @@
+extends SceneTree
+
+# Compares the OpenGL (EGL + FBO readback) and software render backends.
+# Run with: godot --headless --path godot_project --script res://benchmark_render_backends.gd
+
+const VIDEO_PATH = "../assets/video/AV1_Big_Buck_Bunny_720_10s.mp4"
+const RUN_SECONDS = 5.0
+
+func _initialize() -> void:
+	var video = ProjectSettings.globalize_path("res://").path_join(VIDEO_PATH).simplify_path()
+	var backends = {
+		"opengl": MPVPlayer.get_render_backend_opengl(),
+		"software": MPVPlayer.get_render_backend_software(),
+	}
+
+	for backend_name in backends:
+		var player = MPVPlayer.new()
+		root.add_child(player)
+		if not player.initialize(backends[backend_name]):
+			print(backend_name, ": failed to initialize")
+			player.queue_free()
+			continue
+
+		player.load_file(video)
+		player.play()
+
+		var start = Time.get_ticks_usec()
+		var uploads = [0]
+		player.texture_updated.connect(func(_texture): uploads[0] += 1)
+		await create_timer(RUN_SECONDS).timeout
+		var elapsed = (Time.get_ticks_usec() - start) / 1000000.0
+
+		var stats = player.get_render_stats()
+		print("%s: %d frames rendered, %.0f us average render, %.1f uploads/s" % [
+			backend_name, stats["frames_rendered"], stats["average_render_usec"], uploads[0] / elapsed])
+
+		player.queue_free()
+		await process_frame
+
+	quit()
@@ -0,0 +1,29 @@
+extends SceneTree
+
+# Compares reading a video through the res:// stream, through FileAccess and directly from disk.
+# Run with: godot --headless --path godot_project --script res://benchmark_stream_read.gd [-- <path>]
+# Only res:// paths are memory mapped, others measure the FileAccess fallback as the stream.
+
+const VIDEO_PATH = "../assets/video/AV1_Big_Buck_Bunny_720_10s.mp4"
+
+func _initialize() -> void:
+	var video = ProjectSettings.globalize_path("res://").path_join(VIDEO_PATH).simplify_path()
+	var args = OS.get_cmdline_user_args()
+	if args.size() > 0:
+		video = args[0]
+
+	var results = MPVPlayer.benchmark_stream(video)
+	if results.has("error"):
+		print(results["error"])
+		quit()
+		return
+
+	print("%s: %d bytes, stream mode %s" % [video, results["size"], results["mode"]])
+	for prefix in ["stream", "file_access", "direct"]:
+		# direct is missing for files inside a pack
+		if not results.has(prefix + "_mb_s"):
+			continue
+		print("%s: %.0f MB/s sequential, %.1f us per seek and read" % [
+			prefix, results[prefix + "_mb_s"], results[prefix + "_seek_read_usec"]])
+
+	quit()
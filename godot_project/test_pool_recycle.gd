@@ -0,0 +1,57 @@
+extends SceneTree
+
+# Checks that a player handed out again by MPVPlayerPool emits nothing left over from its previous user.
+# Run with: godot --headless --path godot_project --script res://test_pool_recycle.gd
+# Exits with code 1 on failure.
+
+const VIDEO_PATH = "../assets/video/AV1_Big_Buck_Bunny_720_10s.mp4"
+const PLAY_SECONDS = 1.0
+const WATCH_SECONDS = 1.0
+const PLAYER_SIGNALS = [
+	"initialized", "time_changed", "buffering_started", "buffering_ended", "subtitle_changed",
+	"seek_completed", "loading_started", "loading_finished", "load_started", "load_failed",
+	"playlist_item_changed",
+]
+
+func _initialize() -> void:
+	var video = ProjectSettings.globalize_path("res://").path_join(VIDEO_PATH).simplify_path()
+	MPVPlayerPool.set_render_backend(MPVPlayer.get_render_backend_software())
+	# An empty pool makes the first player a miss, so the only idle player later is the released one
+	MPVPlayerPool.set_pool_size(0)
+
+	# First user: play for a while, then hand the player back mid-playback
+	var player = MPVPlayerPool.acquire()
+	root.add_child(player)
+	player.load_file(video)
+	player.play()
+	await create_timer(PLAY_SECONDS).timeout
+	MPVPlayerPool.set_pool_size(1)
+	MPVPlayerPool.release(player)
+
+	# Let the pool see the stop through
+	while MPVPlayerPool.get_stats()["idle"] == 0:
+		await process_frame
+
+	var recycled = MPVPlayerPool.acquire()
+	if recycled != player:
+		print("FAIL: the released player was not handed out again")
+		quit(1)
+		return
+
+	var received = []
+	for signal_info in recycled.get_signal_list():
+		if signal_info["name"] in PLAYER_SIGNALS:
+			var signal_name = signal_info["name"]
+			recycled.connect(signal_name, (func(): received.append(signal_name)).unbind(signal_info["args"].size()))
+
+	root.add_child(recycled)
+	await create_timer(WATCH_SECONDS).timeout
+
+	if received.is_empty():
+		print("PASS: no signals from the previous user")
+	else:
+		print("FAIL: recycled player emitted ", received)
+
+	MPVPlayerPool.release(recycled)
+	MPVPlayerPool.clear()
+	quit(0 if received.is_empty() else 1)
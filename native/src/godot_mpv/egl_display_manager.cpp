@@ -0,0 +1,189 @@
+#include "egl_display_manager.h"
+
+#ifndef __APPLE__
+
+#include <glad/gles2.h>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <cstring>
+
+using namespace godot;
+
+#ifndef EGL_OPENGL_ES3_BIT
+#define EGL_OPENGL_ES3_BIT 0x00000040
+#endif
+
+static void* load_func(const char* name) {
+    return (void*)eglGetProcAddress(name);
+}
+
+EGLDisplayManager& EGLDisplayManager::get_singleton() {
+    static EGLDisplayManager instance;
+    return instance;
+}
+
+bool EGLDisplayManager::acquire() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (ref_count == 0 && !initialize_display()) {
+        return false;
+    }
+
+    ref_count++;
+    return true;
+}
+
+void EGLDisplayManager::release() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (ref_count == 0) {
+        return;
+    }
+
+    ref_count--;
+    if (ref_count == 0) {
+        terminate_display();
+    }
+}
+
+bool EGLDisplayManager::initialize_display() {
+    display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display == EGL_NO_DISPLAY) {
+        UtilityFunctions::print("failed to init egl display");
+        return false;
+    }
+
+    if (!eglInitialize(display, nullptr, nullptr)) {
+        UtilityFunctions::print("failed to init egl");
+        display = EGL_NO_DISPLAY;
+        return false;
+    }
+
+    // Prefer a GLES 3 config so frames can be read back asynchronously through pixel buffers,
+    // fall back to GLES 2 (synchronous readback) when the driver doesn't offer one
+    const EGLint config_attribs_es3[] = {
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT,
+    EGL_RED_SIZE, 8,
+    EGL_GREEN_SIZE, 8,
+    EGL_BLUE_SIZE, 8,
+    EGL_ALPHA_SIZE, 8,
+    EGL_NONE
+    };
+
+    const EGLint config_attribs[] = {
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+    EGL_RED_SIZE, 8,
+    EGL_GREEN_SIZE, 8,
+    EGL_BLUE_SIZE, 8,
+    EGL_ALPHA_SIZE, 8,
+    EGL_NONE
+    };
+
+    EGLint num_configs = 0;
+    client_version = 3;
+    if (!eglChooseConfig(display, config_attribs_es3, &config, 1, &num_configs) || num_configs < 1) {
+        client_version = 2;
+        if (!eglChooseConfig(display, config_attribs, &config, 1, &num_configs) || num_configs < 1) {
+            UtilityFunctions::print("failed to apply egl config");
+            eglTerminate(display);
+            display = EGL_NO_DISPLAY;
+            return false;
+        }
+    }
+
+    const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+    surfaceless = extensions && strstr(extensions, "EGL_KHR_surfaceless_context") != nullptr;
+
+    // Root of the share group, never made current itself
+    const EGLint context_attribs[] = {
+    EGL_CONTEXT_CLIENT_VERSION, client_version,
+    EGL_NONE
+    };
+    share_context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+    if (share_context == EGL_NO_CONTEXT) {
+        UtilityFunctions::print("failed to create shared egl context");
+        eglTerminate(display);
+        display = EGL_NO_DISPLAY;
+        return false;
+    }
+
+    return true;
+}
+
+void EGLDisplayManager::terminate_display() {
+    if (display == EGL_NO_DISPLAY) {
+        return;
+    }
+
+    if (share_context != EGL_NO_CONTEXT) {
+        eglDestroyContext(display, share_context);
+        share_context = EGL_NO_CONTEXT;
+    }
+
+    eglTerminate(display);
+    display = EGL_NO_DISPLAY;
+    config = nullptr;
+}
+
+EGLContext EGLDisplayManager::create_context() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (display == EGL_NO_DISPLAY) {
+        return EGL_NO_CONTEXT;
+    }
+
+    const EGLint context_attribs[] = {
+    EGL_CONTEXT_CLIENT_VERSION, client_version,
+    EGL_NONE
+    };
+    return eglCreateContext(display, config, share_context, context_attribs);
+}
+
+EGLSurface EGLDisplayManager::create_surface() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (display == EGL_NO_DISPLAY || surfaceless) {
+        return EGL_NO_SURFACE;
+    }
+
+    // Players only render into FBOs, the pbuffer just satisfies eglMakeCurrent
+    const EGLint pbuffer_attribs[] = {
+    EGL_WIDTH, 1,
+    EGL_HEIGHT, 1,
+    EGL_NONE
+    };
+    return eglCreatePbufferSurface(display, config, pbuffer_attribs);
+}
+
+void EGLDisplayManager::destroy_context(EGLContext context, EGLSurface surface) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (display == EGL_NO_DISPLAY) {
+        return;
+    }
+
+    if (context != EGL_NO_CONTEXT) {
+        eglDestroyContext(display, context);
+    }
+
+    if (surface != EGL_NO_SURFACE) {
+        eglDestroySurface(display, surface);
+    }
+}
+
+bool EGLDisplayManager::load_gl() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Entry points are the same for every context on the display, load them once
+    if (!gl_loaded) {
+        gl_loaded = gladLoadGLES2((GLADloadfunc)load_func) != 0;
+        if (!gl_loaded) {
+            UtilityFunctions::print("eglGetProcName failed");
+        }
+    }
+    return gl_loaded;
+}
+
+#endif // __APPLE__
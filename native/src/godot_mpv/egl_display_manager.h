@@ -0,0 +1,52 @@
+#ifndef EGL_DISPLAY_MANAGER_H
+#define EGL_DISPLAY_MANAGER_H
+
+#ifndef __APPLE__
+
+#include <EGL/egl.h>
+
+#include <mutex>
+
+// Process-wide EGL display shared by every MPVPlayer.
+// The display, config and a root context are created by the first player and torn down
+// by the last one. Players get their own context in the root context's share group, so
+// GL objects (and driver-side shader caches) can be reused across them.
+class EGLDisplayManager {
+public:
+    static EGLDisplayManager& get_singleton();
+
+    // Take / drop a reference on the shared display, the first acquire initializes it
+    bool acquire();
+    void release();
+
+    EGLDisplay get_display() const { return display; }
+    EGLint get_client_version() const { return client_version; }
+
+    // Per-player objects, created on the shared display. The surface is EGL_NO_SURFACE
+    // when the driver supports surfaceless contexts.
+    EGLContext create_context();
+    EGLSurface create_surface();
+    void destroy_context(EGLContext context, EGLSurface surface);
+
+    // Load the GLES entry points, needs a context current on the calling thread
+    bool load_gl();
+
+private:
+    EGLDisplayManager() = default;
+
+    bool initialize_display();
+    void terminate_display();
+
+    std::mutex mutex;
+    int ref_count = 0;
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLConfig config = nullptr;
+    EGLint client_version = 2;
+    EGLContext share_context = EGL_NO_CONTEXT;
+    bool surfaceless = false;
+    bool gl_loaded = false;
+};
+
+#endif // __APPLE__
+
+#endif // EGL_DISPLAY_MANAGER_H
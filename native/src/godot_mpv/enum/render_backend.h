@@ -0,0 +1,6 @@
+#pragma once
+
+enum RenderBackend {
+    RENDER_BACKEND_OPENGL = 0,
+    RENDER_BACKEND_SOFTWARE = 1
+};
@@ -0,0 +1,77 @@
+#include "frame_cache.h"
+
+#include <algorithm>
+#include <cmath>
+
+uint64_t FrameCache::get_frame_bytes(const Ref<Image>& image) {
+    return image.is_valid() ? (uint64_t)image->get_width() * image->get_height() * 4 : 0;
+}
+
+void FrameCache::set_budget(uint64_t bytes) {
+    budget = bytes;
+    while (!frames.empty() && used_bytes > budget) {
+        used_bytes -= get_frame_bytes(frames.front().image);
+        frames.pop_front();
+    }
+}
+
+int FrameCache::get_capacity(const Ref<Image>& like) const {
+    uint64_t frame_bytes = get_frame_bytes(like);
+    if (frame_bytes == 0) {
+        return 1;
+    }
+    return (int)std::max<uint64_t>(budget / frame_bytes, 1);
+}
+
+double FrameCache::get_frame_duration(double fallback) const {
+    if (frames.size() < 2) {
+        return fallback;
+    }
+    double duration = (frames.back().pts - frames.front().pts) / (double)(frames.size() - 1);
+    return duration > 0.0 ? duration : fallback;
+}
+
+int FrameCache::push_back(double pts, const Ref<Image>& image) {
+    if (!frames.empty()) {
+        Frame& newest = frames.back();
+        if (std::abs(pts - newest.pts) <= PTS_TOLERANCE) {
+            // Redrawn, e.g. after a resize
+            used_bytes -= get_frame_bytes(newest.image);
+            used_bytes += get_frame_bytes(image);
+            newest.image = image;
+            return 0;
+        }
+        if (pts < newest.pts) {
+            return -1;
+        }
+    }
+
+    frames.push_back({pts, image});
+    used_bytes += get_frame_bytes(image);
+
+    // The newest frame always stays, even on its own over the budget
+    int dropped = 0;
+    while (frames.size() > 1 && used_bytes > budget) {
+        used_bytes -= get_frame_bytes(frames.front().image);
+        frames.pop_front();
+        dropped++;
+    }
+    return dropped;
+}
+
+void FrameCache::push_front(const std::vector<Frame>& older) {
+    for (auto it = older.rbegin(); it != older.rend(); ++it) {
+        frames.push_front(*it);
+        used_bytes += get_frame_bytes(it->image);
+    }
+
+    while (frames.size() > 1 && used_bytes > budget) {
+        used_bytes -= get_frame_bytes(frames.back().image);
+        frames.pop_back();
+    }
+}
+
+void FrameCache::clear() {
+    frames.clear();
+    used_bytes = 0;
+}
@@ -0,0 +1,68 @@
+#ifndef FRAME_CACHE_H
+#define FRAME_CACHE_H
+
+#include <godot_cpp/classes/image.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+using namespace godot;
+
+// Consecutive frames around the playhead, oldest first, bounded by a memory budget.
+// Only the main thread uses it: MPVPlayer fills it while frame stepping and serves steps and
+// reverse playback from it, so stepping back through cached frames never reaches mpv.
+class FrameCache {
+public:
+    // Frames this close together are the same frame, mpv's timestamps are rounded to microseconds
+    static constexpr double PTS_TOLERANCE = 0.0005;
+
+    struct Frame {
+        double pts = 0.0;
+        Ref<Image> image;
+    };
+
+    // 0 disables the cache, frames over the budget are dropped from the front
+    void set_budget(uint64_t bytes);
+    uint64_t get_budget() const { return budget; }
+    bool is_enabled() const { return budget > 0; }
+
+    int size() const { return (int)frames.size(); }
+    bool empty() const { return frames.empty(); }
+    const Frame& get(int index) const { return frames[index]; }
+    uint64_t get_used_bytes() const { return used_bytes; }
+
+    // Frames of this size that fit in the budget, at least one
+    int get_capacity(const Ref<Image>& like) const;
+
+    // Average spacing of the cached frames, fallback while there are fewer than two
+    double get_frame_duration(double fallback) const;
+
+    // Add a frame after the newest one, or replace the newest if pts matches it. Returns how
+    // many frames were dropped from the front to stay within the budget, -1 if the frame is
+    // older than the newest one and was not added.
+    int push_back(double pts, const Ref<Image>& image);
+
+    // Add frames older than the oldest one, oldest first. Frames over the budget are dropped
+    // from the back.
+    void push_front(const std::vector<Frame>& older);
+
+    void clear();
+
+    // Steps served from memory and steps that needed mpv
+    void record_hit() { hits++; }
+    void record_miss() { misses++; }
+    uint64_t get_hits() const { return hits; }
+    uint64_t get_misses() const { return misses; }
+
+private:
+    static uint64_t get_frame_bytes(const Ref<Image>& image);
+
+    std::deque<Frame> frames;
+    uint64_t budget = 0;
+    uint64_t used_bytes = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+#endif // FRAME_CACHE_H
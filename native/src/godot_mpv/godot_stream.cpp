@@ -0,0 +1,513 @@
+#include "godot_stream.h"
+
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const uint64_t READAHEAD_BYTES = 8ull * 1024 * 1024; // Kept in flight ahead of mpv's position
+
+// ==================== Main pack ====================
+
+// Godot 4 pack layout, see core/io/file_access_pack.h in the engine
+static const uint32_t PACK_MAGIC = 0x43504447; // "GDPC"
+static const uint32_t PACK_FORMAT_V2 = 2;
+static const uint32_t PACK_FORMAT_V3 = 3;
+static const uint32_t PACK_DIR_ENCRYPTED = 1 << 0;
+static const uint32_t PACK_REL_FILEBASE = 1 << 1;
+static const uint32_t PACK_FILE_ENCRYPTED = 1 << 0;
+static const uint32_t PACK_FILE_REMOVAL = 1 << 1;
+
+namespace {
+
+struct PackEntry {
+    int pack = 0; // Index into PackIndex::packs
+    uint64_t offset = 0;
+    uint64_t size = 0;
+};
+
+// Where the unencrypted files of the main pack live, keyed by their path without res://.
+// Packs store files uncompressed, so such a file is a plain byte range of the pack.
+struct PackIndex {
+    std::vector<String> packs;
+    std::unordered_map<std::string, PackEntry> entries;
+
+    PackIndex() {
+        // The same places the engine looks: --main-pack, <executable>.pck, then a pack
+        // embedded at the end of the executable
+        OS* os = OS::get_singleton();
+        PackedStringArray args = os->get_cmdline_args();
+        for (int64_t i = 0; i + 1 < args.size(); i++) {
+            if (args[i] == "--main-pack") {
+                scan(args[i + 1]);
+            }
+        }
+
+        String executable = os->get_executable_path();
+        scan(executable.get_basename() + ".pck");
+        #ifdef __APPLE__
+        scan(executable.get_base_dir().path_join("../Resources").path_join(executable.get_file().get_basename() + ".pck").simplify_path());
+        #endif
+        scan(executable);
+    }
+
+    void scan(const String& pack_path) {
+        Ref<FileAccess> file = FileAccess::open(pack_path, FileAccess::READ);
+        if (file.is_null() || file->get_length() < 16) {
+            return;
+        }
+
+        uint64_t pack_start = 0;
+        if (file->get_32() != PACK_MAGIC) {
+            // Embedded: the pack is followed by its size and the magic again
+            uint64_t length = file->get_length();
+            file->seek(length - 4);
+            if (file->get_32() != PACK_MAGIC) {
+                return;
+            }
+            file->seek(length - 12);
+            uint64_t pack_size = file->get_64();
+            if (pack_size + 12 > length) {
+                return;
+            }
+            pack_start = length - 12 - pack_size;
+            file->seek(pack_start);
+            if (file->get_32() != PACK_MAGIC) {
+                return;
+            }
+        }
+
+        uint32_t version = file->get_32();
+        if (version != PACK_FORMAT_V2 && version != PACK_FORMAT_V3) {
+            return;
+        }
+        file->get_32(); // Engine major, minor and patch version
+        file->get_32();
+        file->get_32();
+
+        uint32_t pack_flags = file->get_32();
+        uint64_t file_base = file->get_64();
+        if (pack_flags & PACK_DIR_ENCRYPTED) {
+            return;
+        }
+        if (version == PACK_FORMAT_V3 || (pack_flags & PACK_REL_FILEBASE)) {
+            file_base += pack_start;
+        }
+        if (version == PACK_FORMAT_V3) {
+            file->seek(file->get_64() + pack_start);
+        } else {
+            for (int i = 0; i < 16; i++) {
+                file->get_32(); // Reserved
+            }
+        }
+
+        int pack_index = (int)packs.size();
+        packs.push_back(pack_path);
+
+        uint32_t file_count = file->get_32();
+        std::vector<char> name;
+        for (uint32_t i = 0; i < file_count && !file->eof_reached(); i++) {
+            uint32_t name_length = file->get_32();
+            name.assign(name_length + 1, 0);
+            file->get_buffer(reinterpret_cast<uint8_t*>(name.data()), name_length);
+            uint64_t offset = file->get_64();
+            uint64_t size = file->get_64();
+            uint8_t md5[16];
+            file->get_buffer(md5, sizeof(md5));
+            uint32_t flags = file->get_32();
+
+            // Names are padded with zeros, older packs keep the res:// prefix
+            std::string path(name.data());
+            if (path.compare(0, 6, "res://") == 0) {
+                path.erase(0, 6);
+            }
+
+            // A later pack overrides an earlier one, like in the engine
+            if (flags & (PACK_FILE_ENCRYPTED | PACK_FILE_REMOVAL)) {
+                entries.erase(path);
+            } else {
+                entries[path] = {pack_index, file_base + offset, size};
+            }
+        }
+    }
+
+    const PackEntry* find(const String& path) const {
+        CharString key = path.trim_prefix("res://").utf8();
+        auto it = entries.find(key.get_data());
+        return it == entries.end() ? nullptr : &it->second;
+    }
+};
+
+const PackIndex& get_pack_index() {
+    // Built on first use, from whichever mpv thread opens a res:// file first
+    static const PackIndex index;
+    return index;
+}
+
+} // namespace
+
+// ==================== Stream ====================
+
+void GodotStream::register_protocols(mpv_handle* mpv) {
+    static const char* const PROTOCOLS[] = {"res", "user"};
+    for (const char* protocol : PROTOCOLS) {
+        int result = mpv_stream_cb_add_ro(mpv, protocol, nullptr, &GodotStream::open_callback);
+        if (result < 0) {
+            UtilityFunctions::print("Failed to register the ", protocol, ":// protocol: ", mpv_error_string(result));
+        }
+    }
+}
+
+GodotStream* GodotStream::open(const String& path, bool allow_mapping) {
+    GodotStream* stream = new GodotStream();
+
+    // Only read-only res:// content is mapped. user:// and absolute paths may be truncated or
+    // rewritten by another writer, which turns a read of a mapped page into SIGBUS instead of a
+    // short read.
+    if (allow_mapping && path.begins_with("res://")) {
+        // Exported projects serve res:// from the pack even if a loose file of the same name exists
+        const PackIndex& index = get_pack_index();
+        const PackEntry* entry = index.find(path);
+        if (entry && stream->map(index.packs[entry->pack], entry->offset, entry->size)) {
+            stream->mode = MODE_MAPPED_PACK;
+            return stream;
+        }
+
+        String os_path = ProjectSettings::get_singleton()->globalize_path(path);
+        if (!os_path.begins_with("res://") && stream->map(os_path, 0, 0)) {
+            stream->mode = MODE_MAPPED_FILE;
+            return stream;
+        }
+    }
+
+    stream->file = FileAccess::open(path, FileAccess::READ);
+    if (stream->file.is_null()) {
+        delete stream;
+        return nullptr;
+    }
+    stream->size = stream->file->get_length();
+    stream->mode = MODE_FILE_ACCESS;
+    return stream;
+}
+
+GodotStream* GodotStream::map_file(const String& os_path) {
+    GodotStream* stream = new GodotStream();
+    if (!stream->map(os_path, 0, 0)) {
+        delete stream;
+        return nullptr;
+    }
+    stream->mode = MODE_MAPPED_FILE;
+    return stream;
+}
+
+GodotStream::~GodotStream() {
+    unmap();
+}
+
+bool GodotStream::map(const String& os_path, uint64_t offset, uint64_t length) {
+    // length 0 maps from offset to the end of the file
+    #ifdef _WIN32
+    CharString utf8 = os_path.utf8();
+    int wide_length = MultiByteToWideChar(CP_UTF8, 0, utf8.get_data(), -1, nullptr, 0);
+    std::vector<wchar_t> wide(std::max(wide_length, 1));
+    MultiByteToWideChar(CP_UTF8, 0, utf8.get_data(), -1, wide.data(), wide_length);
+
+    HANDLE handle = CreateFileW(wide.data(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(handle, &file_size)) {
+        CloseHandle(handle);
+        return false;
+    }
+    uint64_t total = (uint64_t)file_size.QuadPart;
+    if (length == 0 && offset < total) {
+        length = total - offset;
+    }
+    if (length == 0 || offset + length > total) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    // The view keeps the file and the mapping object alive
+    HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(handle);
+    if (!mapping) {
+        return false;
+    }
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    uint64_t aligned = offset - offset % info.dwAllocationGranularity;
+    size_t view_length = (size_t)(length + (offset - aligned));
+    void* base = MapViewOfFile(mapping, FILE_MAP_READ, (DWORD)(aligned >> 32), (DWORD)(aligned & 0xFFFFFFFF), view_length);
+    CloseHandle(mapping);
+    if (!base) {
+        return false;
+    }
+    #else
+    CharString utf8 = os_path.utf8();
+    int fd = ::open(utf8.get_data(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+    uint64_t total = (uint64_t)st.st_size;
+    if (length == 0 && offset < total) {
+        length = total - offset;
+    }
+    if (length == 0 || offset + length > total) {
+        ::close(fd);
+        return false;
+    }
+
+    // The mapping keeps the file alive. Project files are read-only assets, a file truncated
+    // while mapped would fault instead of returning a short read.
+    uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+    uint64_t aligned = offset - offset % page;
+    size_t view_length = (size_t)(length + (offset - aligned));
+    void* base = mmap(nullptr, view_length, PROT_READ, MAP_PRIVATE, fd, (off_t)aligned);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    // Demuxers read mostly forward: more readahead, and pages behind the position go first
+    madvise(base, view_length, MADV_SEQUENTIAL);
+    #endif
+
+    map_base = base;
+    map_length = view_length;
+    data = static_cast<const uint8_t*>(base) + (offset - aligned);
+    size = length;
+    position = 0;
+    advised_until = 0;
+    return true;
+}
+
+void GodotStream::unmap() {
+    if (!map_base) {
+        return;
+    }
+    #ifdef _WIN32
+    UnmapViewOfFile(map_base);
+    #else
+    munmap(map_base, map_length);
+    #endif
+    map_base = nullptr;
+    map_length = 0;
+    data = nullptr;
+}
+
+void GodotStream::advise_readahead() {
+    // Ask for the next window once mpv is halfway through the previous one, and right away after a seek
+    if (position + READAHEAD_BYTES / 2 < advised_until) {
+        return;
+    }
+    uint64_t end = std::min(position + READAHEAD_BYTES, size);
+
+    #ifndef _WIN32
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)(data + std::max(position, advised_until));
+    start -= start % page;
+    uintptr_t stop = (uintptr_t)(data + end);
+    if (stop > start) {
+        madvise(reinterpret_cast<void*>(start), stop - start, MADV_WILLNEED);
+    }
+    #endif
+
+    advised_until = end;
+}
+
+int64_t GodotStream::read(uint8_t* buffer, uint64_t bytes) {
+    if (position >= size) {
+        return 0;
+    }
+    bytes = std::min(bytes, size - position);
+
+    if (data) {
+        advise_readahead();
+        memcpy(buffer, data + position, bytes);
+    } else {
+        bytes = file->get_buffer(buffer, bytes);
+    }
+    position += bytes;
+    return (int64_t)bytes;
+}
+
+int64_t GodotStream::seek(int64_t offset) {
+    if (offset < 0 || (uint64_t)offset > size) {
+        return MPV_ERROR_GENERIC;
+    }
+    position = (uint64_t)offset;
+    if (file.is_valid()) {
+        file->seek(position);
+    }
+    // Outside the window already advised, the next read starts a new one here
+    if (position >= advised_until || position + READAHEAD_BYTES < advised_until) {
+        advised_until = 0;
+    }
+    return offset;
+}
+
+// ==================== mpv callbacks ====================
+// Called on mpv's demuxer threads, one stream is only ever used by one thread at a time
+
+int GodotStream::open_callback(void*, char* uri, mpv_stream_cb_info* info) {
+    GodotStream* stream = open(String::utf8(uri));
+    if (!stream) {
+        return MPV_ERROR_LOADING_FAILED;
+    }
+
+    info->cookie = stream;
+    info->read_fn = &GodotStream::read_callback;
+    info->seek_fn = &GodotStream::seek_callback;
+    info->size_fn = &GodotStream::size_callback;
+    info->close_fn = &GodotStream::close_callback;
+    return 0;
+}
+
+int64_t GodotStream::read_callback(void* cookie, char* buffer, uint64_t bytes) {
+    return static_cast<GodotStream*>(cookie)->read(reinterpret_cast<uint8_t*>(buffer), bytes);
+}
+
+int64_t GodotStream::seek_callback(void* cookie, int64_t offset) {
+    return static_cast<GodotStream*>(cookie)->seek(offset);
+}
+
+int64_t GodotStream::size_callback(void* cookie) {
+    return static_cast<GodotStream*>(cookie)->get_size();
+}
+
+void GodotStream::close_callback(void* cookie) {
+    delete static_cast<GodotStream*>(cookie);
+}
+
+// ==================== Benchmark ====================
+
+static const uint64_t BENCHMARK_CHUNK = 128 * 1024; // mpv's default stream buffer size
+static const int BENCHMARK_SEEKS = 1000;
+
+namespace {
+
+// stdio on the file itself, what mpv does for a plain path
+struct DirectFile {
+    FILE* file = nullptr;
+
+    explicit DirectFile(const String& os_path) {
+        #ifdef _WIN32
+        CharString utf8 = os_path.utf8();
+        int wide_length = MultiByteToWideChar(CP_UTF8, 0, utf8.get_data(), -1, nullptr, 0);
+        std::vector<wchar_t> wide(std::max(wide_length, 1));
+        MultiByteToWideChar(CP_UTF8, 0, utf8.get_data(), -1, wide.data(), wide_length);
+        file = _wfopen(wide.data(), L"rb");
+        #else
+        file = fopen(os_path.utf8().get_data(), "rb");
+        #endif
+    }
+    ~DirectFile() {
+        if (file) {
+            fclose(file);
+        }
+    }
+
+    int64_t read(uint8_t* buffer, uint64_t bytes) {
+        return (int64_t)fread(buffer, 1, bytes, file);
+    }
+    int64_t seek(int64_t offset) {
+        #ifdef _WIN32
+        return _fseeki64(file, offset, SEEK_SET) == 0 ? offset : -1;
+        #else
+        return fseeko(file, (off_t)offset, SEEK_SET) == 0 ? offset : -1;
+        #endif
+    }
+};
+
+// Sequential throughput in MB/s, then the average time of a seek followed by one chunk read.
+// Every reader gets the same seek positions.
+template <typename Reader>
+void measure(Reader& reader, uint64_t size, const String& prefix, Dictionary& result) {
+    std::vector<uint8_t> buffer(BENCHMARK_CHUNK);
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t total = 0;
+    reader.seek(0);
+    while (true) {
+        int64_t got = reader.read(buffer.data(), BENCHMARK_CHUNK);
+        if (got <= 0) {
+            break;
+        }
+        total += (uint64_t)got;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result[prefix + "_mb_s"] = seconds > 0.0 ? (double)total / (1024.0 * 1024.0) / seconds : 0.0;
+
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_SEEKS; i++) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        reader.seek((int64_t)((state >> 17) % std::max<uint64_t>(size, 1)));
+        reader.read(buffer.data(), BENCHMARK_CHUNK);
+    }
+    double usec = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    result[prefix + "_seek_read_usec"] = usec / BENCHMARK_SEEKS;
+}
+
+} // namespace
+
+Dictionary GodotStream::benchmark(const String& path) {
+    Dictionary result;
+    GodotStream* stream = open(path);
+    if (!stream) {
+        result["error"] = "cannot open " + path;
+        return result;
+    }
+    static const char* const MODE_NAMES[] = {"mapped_file", "mapped_pack", "file_access"};
+    result["mode"] = MODE_NAMES[stream->get_mode()];
+    result["size"] = stream->get_size();
+    uint64_t size = stream->size;
+
+    // Read once first so every reader finds the file in the page cache
+    std::vector<uint8_t> buffer(BENCHMARK_CHUNK);
+    while (stream->read(buffer.data(), BENCHMARK_CHUNK) > 0) {
+    }
+
+    measure(*stream, size, "stream", result);
+    delete stream;
+
+    if (GodotStream* fallback = open(path, false)) {
+        measure(*fallback, size, "file_access", result);
+        delete fallback;
+    }
+
+    bool virtual_path = path.begins_with("res://") || path.begins_with("user://");
+    String os_path = virtual_path ? ProjectSettings::get_singleton()->globalize_path(path) : path;
+    DirectFile direct(os_path);
+    if (direct.file) {
+        measure(direct, size, "direct", result);
+    }
+    return result;
+}
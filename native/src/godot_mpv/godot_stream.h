@@ -0,0 +1,79 @@
+#ifndef GODOT_STREAM_H
+#define GODOT_STREAM_H
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include <mpv/client.h>
+#include <mpv/stream_cb.h>
+
+#include <cstdint>
+
+using namespace godot;
+
+// res:// and user:// for mpv. Both are registered as mpv protocols whose reads go through Godot,
+// so load_file plays files from the project and from exported packs without extracting them.
+// res:// files, loose in the project or stored unencrypted in the main pack, are memory mapped: a
+// read is a memcpy, and seeking and the size are O(1). Anything else (user://, which other writers
+// may truncate under a mapping, encrypted packs, packs loaded at runtime, Android assets) is read
+// through FileAccess.
+class GodotStream {
+public:
+    enum Mode {
+        MODE_MAPPED_FILE,
+        MODE_MAPPED_PACK,
+        MODE_FILE_ACCESS
+    };
+
+    // Register the res and user protocols on an initialized mpv instance
+    static void register_protocols(mpv_handle* mpv);
+
+    // Open a res://, user:// or absolute path, nullptr if it can't be read. allow_mapping = false
+    // forces the FileAccess path, for comparing the two.
+    static GodotStream* open(const String& path, bool allow_mapping = true);
+
+    // Map a whole file on disk, nullptr if it can't be mapped. Only for files that are replaced
+    // rather than rewritten in place, for the reason given above.
+    static GodotStream* map_file(const String& os_path);
+    ~GodotStream();
+
+    // mpv's stream_cb semantics: bytes read (0 at the end), new position or a negative mpv_error
+    int64_t read(uint8_t* buffer, uint64_t bytes);
+    int64_t seek(int64_t offset);
+    int64_t get_size() const { return (int64_t)size; }
+    Mode get_mode() const { return mode; }
+    // The file's bytes when mapped, nullptr otherwise
+    const uint8_t* get_mapped_data() const { return data; }
+
+    // Read a whole file and seek around in it through the stream, through FileAccess and directly
+    // with stdio, reporting MB/s and the time per seek and read for each
+    static Dictionary benchmark(const String& path);
+
+private:
+    GodotStream() = default;
+
+    bool map(const String& os_path, uint64_t offset, uint64_t length);
+    void unmap();
+    void advise_readahead();
+
+    static int open_callback(void* user_data, char* uri, mpv_stream_cb_info* info);
+    static int64_t read_callback(void* cookie, char* buffer, uint64_t bytes);
+    static int64_t seek_callback(void* cookie, int64_t offset);
+    static int64_t size_callback(void* cookie);
+    static void close_callback(void* cookie);
+
+    Mode mode = MODE_FILE_ACCESS;
+    uint64_t size = 0;
+    uint64_t position = 0;
+
+    // Mapped view, data points at the first byte of the file inside the page-aligned mapping
+    void* map_base = nullptr;
+    size_t map_length = 0;
+    const uint8_t* data = nullptr;
+    uint64_t advised_until = 0; // End of the range already handed to the kernel for readahead
+
+    Ref<FileAccess> file;
+};
+
+#endif // GODOT_STREAM_H
@@ -0,0 +1,662 @@
+#include "keyframe_index.h"
+
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static const char* CACHE_DIR = "user://keyframe_index";
+static const uint32_t CACHE_MAGIC = 0x3149464B; // "KFI1"
+static const uint64_t MAX_INDEX_BYTES = 256ull * 1024 * 1024; // Larger moov or Cues elements are not read
+static const uint64_t READ_CHUNK_BYTES = 1024 * 1024; // cancelled is checked between chunks
+
+KeyframeIndex::KeyframeIndex(const String& p_path) : path(p_path) {
+    thread = std::thread(&KeyframeIndex::build, this);
+}
+
+KeyframeIndex::~KeyframeIndex() {
+    cancelled.store(true);
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+double KeyframeIndex::get_before(double time) const {
+    if (!is_ready()) {
+        return -1.0;
+    }
+    auto it = std::upper_bound(times.begin(), times.end(), time);
+    return it == times.begin() ? -1.0 : *(it - 1);
+}
+
+double KeyframeIndex::get_after(double time) const {
+    if (!is_ready()) {
+        return -1.0;
+    }
+    auto it = std::upper_bound(times.begin(), times.end(), time);
+    return it == times.end() ? -1.0 : *it;
+}
+
+double KeyframeIndex::get_nearest(double time) const {
+    double before = get_before(time);
+    double after = get_after(time);
+    if (before < 0.0 || after < 0.0) {
+        return before < 0.0 ? after : before;
+    }
+    return time - before <= after - time ? before : after;
+}
+
+void KeyframeIndex::build() {
+    // This method runs on the index's own thread
+    Ref<FileAccess> file = FileAccess::open(path, FileAccess::READ);
+    if (file.is_null()) {
+        ready.store(true, std::memory_order_release);
+        return;
+    }
+
+    uint64_t size = file->get_length();
+    uint64_t modified_time = FileAccess::get_modified_time(path);
+
+    if (!load_cache(size, modified_time)) {
+        uint8_t magic[8] = {};
+        file->get_buffer(magic, sizeof(magic));
+
+        bool found = false;
+        if (memcmp(magic, "\x1A\x45\xDF\xA3", 4) == 0) {
+            found = scan_matroska(file);
+        } else if (memcmp(magic + 4, "ftyp", 4) == 0 || memcmp(magic + 4, "moov", 4) == 0 ||
+                   memcmp(magic + 4, "free", 4) == 0 || memcmp(magic + 4, "wide", 4) == 0) {
+            found = scan_mp4(file);
+        }
+
+        if (found) {
+            std::sort(times.begin(), times.end());
+            times.erase(std::unique(times.begin(), times.end()), times.end());
+        } else {
+            times.clear();
+        }
+
+        // A file without a usable index is remembered too, so it isn't scanned again
+        if (!cancelled.load()) {
+            save_cache(size, modified_time);
+        }
+    }
+
+    ready.store(true, std::memory_order_release);
+}
+
+// ==================== MP4 ====================
+
+static uint32_t read_u32(const uint8_t* p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | (uint32_t)p[3];
+}
+
+static uint64_t read_u64(const uint8_t* p) {
+    return (uint64_t)read_u32(p) << 32 | read_u32(p + 4);
+}
+
+static constexpr uint32_t fourcc(const char (&s)[5]) {
+    return (uint32_t)(uint8_t)s[0] << 24 | (uint32_t)(uint8_t)s[1] << 16 | (uint32_t)(uint8_t)s[2] << 8 | (uint32_t)(uint8_t)s[3];
+}
+
+struct Mp4Box {
+    uint32_t type = 0;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+static bool next_box(const uint8_t*& cursor, const uint8_t* end, Mp4Box& box) {
+    if (end - cursor < 8) {
+        return false;
+    }
+
+    uint64_t size = read_u32(cursor);
+    uint64_t header = 8;
+    box.type = read_u32(cursor + 4);
+    if (size == 1) {
+        if (end - cursor < 16) {
+            return false;
+        }
+        size = read_u64(cursor + 8);
+        header = 16;
+    } else if (size == 0) {
+        size = end - cursor;
+    }
+    if (size < header || size > (uint64_t)(end - cursor)) {
+        return false;
+    }
+
+    box.data = cursor + header;
+    box.size = size - header;
+    cursor += size;
+    return true;
+}
+
+static bool find_box(const uint8_t* data, size_t size, uint32_t type, Mp4Box& found) {
+    const uint8_t* cursor = data;
+    Mp4Box box;
+    while (next_box(cursor, data + size, box)) {
+        if (box.type == type) {
+            found = box;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool read_mp4_keyframes(const Mp4Box& trak, const Mp4Box& mdhd, const Mp4Box& stbl, uint32_t movie_timescale, std::vector<double>& times) {
+    uint32_t timescale = read_u32(mdhd.data + (mdhd.data[0] == 1 ? 20 : 12));
+    if (timescale == 0) {
+        return false;
+    }
+
+    // Without a sync sample table every sample is a keyframe and seeks are cheap already
+    Mp4Box stts, stss, ctts;
+    if (!find_box(stbl.data, stbl.size, fourcc("stts"), stts) || stts.size < 8 ||
+        !find_box(stbl.data, stbl.size, fourcc("stss"), stss) || stss.size < 8) {
+        return false;
+    }
+    bool has_ctts = find_box(stbl.data, stbl.size, fourcc("ctts"), ctts) && ctts.size >= 8;
+
+    uint32_t sync_count = read_u32(stss.data + 4);
+    uint32_t stts_count = read_u32(stts.data + 4);
+    uint32_t ctts_count = has_ctts ? read_u32(ctts.data + 4) : 0;
+    if (8 + (uint64_t)sync_count * 4 > stss.size || 8 + (uint64_t)stts_count * 8 > stts.size ||
+        8 + (uint64_t)ctts_count * 8 > (has_ctts ? ctts.size : 0)) {
+        return false;
+    }
+
+    // Edit list: leading empty edits delay the track, the first real edit skips into the media
+    double start_offset = 0.0;
+    int64_t media_start = 0;
+    Mp4Box edts, elst;
+    if (find_box(trak.data, trak.size, fourcc("edts"), edts) &&
+        find_box(edts.data, edts.size, fourcc("elst"), elst) && elst.size >= 8) {
+        bool v1 = elst.data[0] == 1;
+        size_t entry_size = v1 ? 20 : 12;
+        uint32_t entry_count = read_u32(elst.data + 4);
+        for (uint32_t i = 0; i < entry_count && 8 + (uint64_t)(i + 1) * entry_size <= elst.size; i++) {
+            const uint8_t* entry = elst.data + 8 + i * entry_size;
+            uint64_t duration = v1 ? read_u64(entry) : read_u32(entry);
+            int64_t media_time = v1 ? (int64_t)read_u64(entry + 8) : (int32_t)read_u32(entry + 4);
+            if (media_time == -1) {
+                if (movie_timescale != 0) {
+                    start_offset += (double)duration / movie_timescale;
+                }
+                continue;
+            }
+            media_start = media_time;
+            break;
+        }
+    }
+
+    // Walk the decode time and composition offset runs alongside the ascending sync sample numbers
+    uint32_t stts_index = 0;
+    uint64_t stts_first_sample = 1;
+    uint64_t stts_first_dts = 0;
+    uint32_t ctts_index = 0;
+    uint64_t ctts_first_sample = 1;
+
+    times.reserve(sync_count);
+    for (uint32_t i = 0; i < sync_count; i++) {
+        uint64_t sample = read_u32(stss.data + 8 + i * 4);
+
+        while (stts_index < stts_count) {
+            uint32_t run_count = read_u32(stts.data + 8 + stts_index * 8);
+            if (sample < stts_first_sample + run_count) {
+                break;
+            }
+            stts_first_dts += (uint64_t)run_count * read_u32(stts.data + 12 + stts_index * 8);
+            stts_first_sample += run_count;
+            stts_index++;
+        }
+        if (stts_index == stts_count) {
+            break;
+        }
+        uint64_t dts = stts_first_dts + (sample - stts_first_sample) * read_u32(stts.data + 12 + stts_index * 8);
+
+        int64_t composition_offset = 0;
+        while (ctts_index < ctts_count) {
+            uint32_t run_count = read_u32(ctts.data + 8 + ctts_index * 8);
+            if (sample < ctts_first_sample + run_count) {
+                composition_offset = (int32_t)read_u32(ctts.data + 12 + ctts_index * 8);
+                break;
+            }
+            ctts_first_sample += run_count;
+            ctts_index++;
+        }
+
+        double pts = (double)((int64_t)dts + composition_offset - media_start) / timescale + start_offset;
+        times.push_back(std::max(pts, 0.0));
+    }
+
+    return !times.empty();
+}
+
+bool KeyframeIndex::scan_mp4(const Ref<FileAccess>& file) {
+    // Find moov among the top-level boxes, it may come after a multi-GB mdat
+    uint64_t length = file->get_length();
+    uint64_t offset = 0;
+    std::vector<uint8_t> moov;
+
+    while (offset + 8 <= length && !cancelled.load()) {
+        uint8_t header[16];
+        file->seek(offset);
+        uint64_t read = file->get_buffer(header, sizeof(header));
+
+        uint64_t size = read_u32(header);
+        uint64_t header_size = 8;
+        if (size == 1) {
+            if (read < 16) {
+                return false;
+            }
+            size = read_u64(header + 8);
+            header_size = 16;
+        } else if (size == 0) {
+            size = length - offset;
+        }
+        if (size < header_size) {
+            return false;
+        }
+
+        if (read_u32(header + 4) == fourcc("moov")) {
+            uint64_t payload = size - header_size;
+            if (!read_payload(file, offset + header_size, payload, moov)) {
+                return false;
+            }
+            break;
+        }
+        offset += size;
+    }
+    if (moov.empty()) {
+        return false;
+    }
+
+    Mp4Box mvhd;
+    uint32_t movie_timescale = 0;
+    if (find_box(moov.data(), moov.size(), fourcc("mvhd"), mvhd) && mvhd.size >= 24) {
+        movie_timescale = read_u32(mvhd.data + (mvhd.data[0] == 1 ? 20 : 12));
+    }
+
+    // The first video track decides, like mpv's default video track selection
+    const uint8_t* cursor = moov.data();
+    Mp4Box trak;
+    while (next_box(cursor, moov.data() + moov.size(), trak)) {
+        Mp4Box mdia, hdlr, mdhd, minf, stbl;
+        if (trak.type != fourcc("trak") ||
+            !find_box(trak.data, trak.size, fourcc("mdia"), mdia) ||
+            !find_box(mdia.data, mdia.size, fourcc("hdlr"), hdlr) || hdlr.size < 12 ||
+            read_u32(hdlr.data + 8) != fourcc("vide")) {
+            continue;
+        }
+
+        // Fragmented files keep their samples in moof boxes, the moov tables are empty
+        if (!find_box(mdia.data, mdia.size, fourcc("mdhd"), mdhd) || mdhd.size < 24 ||
+            !find_box(mdia.data, mdia.size, fourcc("minf"), minf) ||
+            !find_box(minf.data, minf.size, fourcc("stbl"), stbl)) {
+            return false;
+        }
+        return read_mp4_keyframes(trak, mdhd, stbl, movie_timescale, times);
+    }
+    return false;
+}
+
+// ==================== Matroska ====================
+
+static const uint64_t EBML_HEADER = 0x1A45DFA3;
+static const uint64_t MKV_SEGMENT = 0x18538067;
+static const uint64_t MKV_SEEK_HEAD = 0x114D9B74;
+static const uint64_t MKV_SEEK = 0x4DBB;
+static const uint64_t MKV_SEEK_ID = 0x53AB;
+static const uint64_t MKV_SEEK_POSITION = 0x53AC;
+static const uint64_t MKV_INFO = 0x1549A966;
+static const uint64_t MKV_TIMESTAMP_SCALE = 0x2AD7B1;
+static const uint64_t MKV_TRACKS = 0x1654AE6B;
+static const uint64_t MKV_TRACK_ENTRY = 0xAE;
+static const uint64_t MKV_TRACK_NUMBER = 0xD7;
+static const uint64_t MKV_TRACK_TYPE = 0x83;
+static const uint64_t MKV_CLUSTER = 0x1F43B675;
+static const uint64_t MKV_CUES = 0x1C53BB6B;
+static const uint64_t MKV_CUE_POINT = 0xBB;
+static const uint64_t MKV_CUE_TIME = 0xB3;
+static const uint64_t MKV_CUE_TRACK_POSITIONS = 0xB7;
+static const uint64_t MKV_CUE_TRACK = 0xF7;
+
+// EBML variable-length integer. IDs keep their length marker, sizes drop it.
+static bool read_ebml_vint(const uint8_t*& cursor, const uint8_t* end, uint64_t& value, bool keep_marker, bool* unknown = nullptr) {
+    if (cursor >= end) {
+        return false;
+    }
+
+    uint8_t first = *cursor;
+    int length = 1;
+    uint8_t mask = 0x80;
+    while (length <= 8 && !(first & mask)) {
+        mask >>= 1;
+        length++;
+    }
+    if (length > 8 || end - cursor < length) {
+        return false;
+    }
+
+    value = keep_marker ? first : (first & (mask - 1));
+    bool all_ones = (first & (mask - 1)) == (uint8_t)(mask - 1);
+    for (int i = 1; i < length; i++) {
+        value = value << 8 | cursor[i];
+        all_ones = all_ones && cursor[i] == 0xFF;
+    }
+    if (unknown) {
+        *unknown = !keep_marker && all_ones;
+    }
+    cursor += length;
+    return true;
+}
+
+struct EbmlElement {
+    uint64_t id = 0;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+static bool next_element(const uint8_t*& cursor, const uint8_t* end, EbmlElement& element) {
+    uint64_t size = 0;
+    bool unknown = false;
+    if (!read_ebml_vint(cursor, end, element.id, true) || !read_ebml_vint(cursor, end, size, false, &unknown)) {
+        return false;
+    }
+    if (unknown || size > (uint64_t)(end - cursor)) {
+        size = end - cursor;
+    }
+    element.data = cursor;
+    element.size = size;
+    cursor += size;
+    return true;
+}
+
+static uint64_t read_ebml_uint(const EbmlElement& element) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < element.size && i < 8; i++) {
+        value = value << 8 | element.data[i];
+    }
+    return value;
+}
+
+// Returns the length of the element header at offset, 0 if there is none
+static uint64_t read_element_header(const Ref<FileAccess>& file, uint64_t offset, uint64_t& id, uint64_t& size, bool& unknown_size) {
+    uint8_t header[12];
+    file->seek(offset);
+    uint64_t read = file->get_buffer(header, sizeof(header));
+
+    const uint8_t* cursor = header;
+    if (!read_ebml_vint(cursor, header + read, id, true) || !read_ebml_vint(cursor, header + read, size, false, &unknown_size)) {
+        return 0;
+    }
+    return cursor - header;
+}
+
+bool KeyframeIndex::read_payload(const Ref<FileAccess>& file, uint64_t offset, uint64_t size, std::vector<uint8_t>& payload) const {
+    if (size > MAX_INDEX_BYTES) {
+        return false;
+    }
+    payload.resize(size);
+    file->seek(offset);
+
+    // In chunks, so a new file or a reset player doesn't wait on one huge read while joining
+    for (uint64_t done = 0; done < size;) {
+        if (cancelled.load()) {
+            return false;
+        }
+        uint64_t chunk = std::min(size - done, READ_CHUNK_BYTES);
+        if (file->get_buffer(payload.data() + done, chunk) != chunk) {
+            return false;
+        }
+        done += chunk;
+    }
+    return true;
+}
+
+bool KeyframeIndex::scan_matroska(const Ref<FileAccess>& file) {
+    uint64_t length = file->get_length();
+    uint64_t id = 0;
+    uint64_t size = 0;
+    bool unknown_size = false;
+
+    uint64_t header = read_element_header(file, 0, id, size, unknown_size);
+    if (header == 0 || id != EBML_HEADER || unknown_size) {
+        return false;
+    }
+    uint64_t offset = header + size;
+    header = read_element_header(file, offset, id, size, unknown_size);
+    if (header == 0 || id != MKV_SEGMENT) {
+        return false;
+    }
+    uint64_t segment_start = offset + header;
+    uint64_t segment_end = unknown_size ? length : std::min(length, segment_start + size);
+
+    uint64_t timestamp_scale = 1000000; // Nanoseconds per timestamp unit
+    uint64_t video_track = 0; // 0 = unknown, every cue point counts
+    uint64_t info_offset = 0;
+    uint64_t tracks_offset = 0;
+    uint64_t cues_offset = 0;
+    bool has_info = false;
+    bool has_tracks = false;
+    std::vector<uint8_t> cues;
+    std::vector<uint8_t> payload;
+
+    auto parse_children = [&](uint64_t parent_id, const std::vector<uint8_t>& data) {
+        const uint8_t* cursor = data.data();
+        const uint8_t* end = cursor + data.size();
+        EbmlElement child;
+        while (next_element(cursor, end, child)) {
+            if (parent_id == MKV_SEEK_HEAD && child.id == MKV_SEEK) {
+                uint64_t target_id = 0;
+                uint64_t position = 0;
+                const uint8_t* seek_cursor = child.data;
+                EbmlElement field;
+                while (next_element(seek_cursor, child.data + child.size, field)) {
+                    if (field.id == MKV_SEEK_ID) {
+                        target_id = read_ebml_uint(field);
+                    } else if (field.id == MKV_SEEK_POSITION) {
+                        position = segment_start + read_ebml_uint(field);
+                    }
+                }
+                if (target_id == MKV_INFO) {
+                    info_offset = position;
+                } else if (target_id == MKV_TRACKS) {
+                    tracks_offset = position;
+                } else if (target_id == MKV_CUES) {
+                    cues_offset = position;
+                }
+            } else if (parent_id == MKV_INFO && child.id == MKV_TIMESTAMP_SCALE) {
+                uint64_t scale = read_ebml_uint(child);
+                timestamp_scale = scale != 0 ? scale : timestamp_scale;
+            } else if (parent_id == MKV_TRACKS && child.id == MKV_TRACK_ENTRY && video_track == 0) {
+                uint64_t number = 0;
+                uint64_t type = 0;
+                const uint8_t* track_cursor = child.data;
+                EbmlElement field;
+                while (next_element(track_cursor, child.data + child.size, field)) {
+                    if (field.id == MKV_TRACK_NUMBER) {
+                        number = read_ebml_uint(field);
+                    } else if (field.id == MKV_TRACK_TYPE) {
+                        type = read_ebml_uint(field);
+                    }
+                }
+                if (type == 1) {
+                    video_track = number;
+                }
+            }
+        }
+    };
+
+    // Walk the top-level elements. Clusters are skipped by their size until the SeekHead
+    // (or the walk itself) has located the Cues, which usually sit at the end.
+    offset = segment_start;
+    while (offset < segment_end && !cancelled.load()) {
+        header = read_element_header(file, offset, id, size, unknown_size);
+        if (header == 0 || unknown_size || (id == MKV_CLUSTER && cues_offset != 0)) {
+            break;
+        }
+
+        uint64_t data_offset = offset + header;
+        if (id == MKV_CUES) {
+            if (!read_payload(file, data_offset, size, cues)) {
+                return false;
+            }
+            break;
+        }
+        if (id == MKV_SEEK_HEAD || id == MKV_INFO || id == MKV_TRACKS) {
+            if (!read_payload(file, data_offset, size, payload)) {
+                return false;
+            }
+            parse_children(id, payload);
+            has_info = has_info || id == MKV_INFO;
+            has_tracks = has_tracks || id == MKV_TRACKS;
+        }
+        offset = data_offset + size;
+    }
+
+    // Whatever the walk didn't reach is read through the SeekHead
+    auto read_at = [&](uint64_t element_offset, uint64_t expected_id, std::vector<uint8_t>& data) {
+        if (element_offset == 0 || element_offset >= segment_end) {
+            return false;
+        }
+        uint64_t element_header = read_element_header(file, element_offset, id, size, unknown_size);
+        return element_header != 0 && id == expected_id && !unknown_size &&
+            read_payload(file, element_offset + element_header, size, data);
+    };
+    if (!has_info && read_at(info_offset, MKV_INFO, payload)) {
+        parse_children(MKV_INFO, payload);
+    }
+    if (!has_tracks && read_at(tracks_offset, MKV_TRACKS, payload)) {
+        parse_children(MKV_TRACKS, payload);
+    }
+    if (cues.empty() && !read_at(cues_offset, MKV_CUES, cues)) {
+        return false;
+    }
+
+    // Cue points list keyframes, keep the ones of the video track
+    double seconds_per_unit = (double)timestamp_scale / 1e9;
+    const uint8_t* cursor = cues.data();
+    EbmlElement cue_point;
+    while (next_element(cursor, cues.data() + cues.size(), cue_point)) {
+        if (cue_point.id != MKV_CUE_POINT) {
+            continue;
+        }
+
+        uint64_t cue_time = 0;
+        bool matches = video_track == 0;
+        const uint8_t* point_cursor = cue_point.data;
+        EbmlElement field;
+        while (next_element(point_cursor, cue_point.data + cue_point.size, field)) {
+            if (field.id == MKV_CUE_TIME) {
+                cue_time = read_ebml_uint(field);
+            } else if (field.id == MKV_CUE_TRACK_POSITIONS && !matches) {
+                const uint8_t* position_cursor = field.data;
+                EbmlElement position;
+                while (next_element(position_cursor, field.data + field.size, position)) {
+                    if (position.id == MKV_CUE_TRACK && read_ebml_uint(position) == video_track) {
+                        matches = true;
+                    }
+                }
+            }
+        }
+
+        if (matches) {
+            times.push_back(cue_time * seconds_per_unit);
+        }
+    }
+
+    return !times.empty();
+}
+
+// ==================== Cache ====================
+
+// Layout: magic, file size, modification time, keyframe count, first time in microseconds,
+// then one 32-bit microsecond delta per following keyframe. All little-endian.
+
+String KeyframeIndex::get_cache_path() const {
+    return String(CACHE_DIR) + "/" + path.md5_text() + ".kfi";
+}
+
+bool KeyframeIndex::load_cache(uint64_t size, uint64_t modified_time) {
+    Ref<FileAccess> file = FileAccess::open(get_cache_path(), FileAccess::READ);
+    if (file.is_null()) {
+        return false;
+    }
+    if (file->get_32() != CACHE_MAGIC || file->get_64() != size || file->get_64() != modified_time) {
+        return false;
+    }
+
+    uint32_t count = file->get_32();
+    if (count == 0) {
+        times.clear();
+        return true;
+    }
+
+    // count comes from disk, a corrupt or truncated file must not size the read
+    uint64_t usec = file->get_64();
+    uint64_t delta_bytes = (uint64_t)(count - 1) * 4;
+    if (delta_bytes > file->get_length() - file->get_position()) {
+        return false;
+    }
+    PackedByteArray deltas = file->get_buffer((int64_t)delta_bytes);
+    if (deltas.size() != (int64_t)(count - 1) * 4) {
+        return false;
+    }
+
+    const uint8_t* data = deltas.ptr();
+    times.resize(count);
+    times[0] = usec / 1e6;
+    for (uint32_t i = 1; i < count; i++) {
+        const uint8_t* p = data + (i - 1) * 4;
+        usec += (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+        times[i] = usec / 1e6;
+    }
+    return true;
+}
+
+void KeyframeIndex::save_cache(uint64_t size, uint64_t modified_time) const {
+    DirAccess::make_dir_recursive_absolute(CACHE_DIR);
+
+    // Written under a temporary name and renamed over the cache, so a crash never leaves a torn file
+    String cache_path = get_cache_path();
+    String temp_path = cache_path + ".tmp";
+    Ref<FileAccess> file = FileAccess::open(temp_path, FileAccess::WRITE);
+    if (file.is_null()) {
+        return;
+    }
+
+    file->store_32(CACHE_MAGIC);
+    file->store_64(size);
+    file->store_64(modified_time);
+    file->store_32((uint32_t)times.size());
+    if (!times.empty()) {
+        uint64_t previous = (uint64_t)std::llround(times[0] * 1e6);
+        file->store_64(previous);
+
+        PackedByteArray deltas;
+        deltas.resize((int64_t)(times.size() - 1) * 4);
+        uint8_t* data = deltas.ptrw();
+        for (size_t i = 1; i < times.size(); i++) {
+            uint64_t usec = (uint64_t)std::llround(times[i] * 1e6);
+            uint32_t delta = (uint32_t)std::min<uint64_t>(usec - previous, UINT32_MAX);
+            previous += delta;
+
+            uint8_t* p = data + (i - 1) * 4;
+            p[0] = delta & 0xFF;
+            p[1] = (delta >> 8) & 0xFF;
+            p[2] = (delta >> 16) & 0xFF;
+            p[3] = delta >> 24;
+        }
+        file->store_buffer(deltas);
+    }
+
+    bool written = file->get_error() == OK;
+    file->close();
+    if (!written || DirAccess::rename_absolute(temp_path, cache_path) != OK) {
+        DirAccess::remove_absolute(temp_path);
+    }
+}
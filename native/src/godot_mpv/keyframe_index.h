@@ -0,0 +1,57 @@
+#ifndef KEYFRAME_INDEX_H
+#define KEYFRAME_INDEX_H
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace godot;
+
+// Presentation times of a local file's video keyframes.
+// They are read from the container's own index (MP4 stss/stts/ctts, Matroska Cues) on a
+// background thread, so nothing is decoded and only the index is read from disk. The result is
+// cached under user://keyframe_index keyed by path, size and modification time, so each file is
+// only scanned once.
+class KeyframeIndex {
+public:
+    // Starts building right away, path is anything FileAccess can open
+    explicit KeyframeIndex(const String& path);
+    // Cancels a build still running and waits for it
+    ~KeyframeIndex();
+
+    const String& get_path() const { return path; }
+
+    // Set once the build has finished. A finished index may still be empty, for containers
+    // without an index or where every frame is a keyframe.
+    bool is_ready() const { return ready.load(std::memory_order_acquire); }
+
+    // Only valid once is_ready(), sorted, in seconds
+    const std::vector<double>& get_times() const { return times; }
+
+    // Nearest keyframe at or before / strictly after time, -1 if there is none
+    double get_before(double time) const;
+    double get_after(double time) const;
+    double get_nearest(double time) const;
+
+private:
+    void build();
+    bool scan_mp4(const Ref<FileAccess>& file);
+    bool scan_matroska(const Ref<FileAccess>& file);
+    // Read size bytes at offset, false if it is too large, short or the build was cancelled
+    bool read_payload(const Ref<FileAccess>& file, uint64_t offset, uint64_t size, std::vector<uint8_t>& payload) const;
+    String get_cache_path() const;
+    bool load_cache(uint64_t size, uint64_t modified_time);
+    void save_cache(uint64_t size, uint64_t modified_time) const;
+
+    String path;
+    std::vector<double> times; // Written by the build thread before ready is set
+    std::atomic<bool> ready{false};
+    std::atomic<bool> cancelled{false};
+    std::thread thread;
+};
+
+#endif // KEYFRAME_INDEX_H
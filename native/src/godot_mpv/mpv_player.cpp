@@ -1,4 +1,7 @@
 #include "mpv_player.h"
+#include "egl_display_manager.h"
+#include "godot_stream.h"
+#include "player_reaper.h"
 #include <godot_cpp/core/error_macros.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <godot_cpp/classes/engine.hpp>
@@ -8,21 +11,32 @@
 #include <godot_cpp/core/memory.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <string>
 
 using namespace godot;
 
-// Static member for callback context
-static MPVPlayer* g_instance = nullptr;
-
-#ifndef __APPLE__
-void* load_func(const char* name) {
-    return (void*)eglGetProcAddress(name);
-}
-#endif
 void MPVPlayer::_bind_methods() {
     // Register methods
-    ClassDB::bind_method(D_METHOD("initialize"), &MPVPlayer::initialize);
-    ClassDB::bind_method(D_METHOD("load_file"), &MPVPlayer::load_file);
+    ClassDB::bind_method(D_METHOD("initialize", "backend"), &MPVPlayer::initialize, DEFVAL(RENDER_BACKEND_OPENGL));
+    ClassDB::bind_method(D_METHOD("initialize_async", "backend"), &MPVPlayer::initialize_async, DEFVAL(RENDER_BACKEND_OPENGL));
+    ClassDB::bind_method(D_METHOD("is_initializing"), &MPVPlayer::is_initializing);
+    ClassDB::bind_method(D_METHOD("is_initialized"), &MPVPlayer::is_initialized);
+    ClassDB::bind_method(D_METHOD("get_init_time_usec"), &MPVPlayer::get_init_time_usec);
+    ClassDB::bind_method(D_METHOD("reset_for_reuse"), &MPVPlayer::reset_for_reuse);
+    ClassDB::bind_method(D_METHOD("load_file", "path"), &MPVPlayer::load_file);
+    ClassDB::bind_method(D_METHOD("playlist_append", "path"), &MPVPlayer::playlist_append);
+    ClassDB::bind_method(D_METHOD("playlist_insert", "index", "path"), &MPVPlayer::playlist_insert);
+    ClassDB::bind_method(D_METHOD("playlist_remove", "index"), &MPVPlayer::playlist_remove);
+    ClassDB::bind_method(D_METHOD("playlist_move", "from", "to"), &MPVPlayer::playlist_move);
+    ClassDB::bind_method(D_METHOD("playlist_clear"), &MPVPlayer::playlist_clear);
+    ClassDB::bind_method(D_METHOD("playlist_next"), &MPVPlayer::playlist_next);
+    ClassDB::bind_method(D_METHOD("playlist_prev"), &MPVPlayer::playlist_prev);
+    ClassDB::bind_method(D_METHOD("set_playlist_index", "index"), &MPVPlayer::set_playlist_index);
+    ClassDB::bind_method(D_METHOD("get_playlist_index"), &MPVPlayer::get_playlist_index);
+    ClassDB::bind_method(D_METHOD("get_playlist_count"), &MPVPlayer::get_playlist_count);
+    ClassDB::bind_method(D_METHOD("set_playlist_loop", "enabled"), &MPVPlayer::set_playlist_loop);
     ClassDB::bind_method(D_METHOD("play"), &MPVPlayer::play);
     ClassDB::bind_method(D_METHOD("set_volume", "value"), &MPVPlayer::set_volume);
     ClassDB::bind_method(D_METHOD("get_volume"), &MPVPlayer::get_volume);
@@ -31,13 +45,45 @@ void MPVPlayer::_bind_methods() {
     ClassDB::bind_method(D_METHOD("seek_content_pos", "pos"), &MPVPlayer::seek_content_pos);
     ClassDB::bind_method(D_METHOD("seek", "seconds", "relative"), &MPVPlayer::seek);
     ClassDB::bind_method(D_METHOD("seek_to_percentage", "pos"), &MPVPlayer::seek_to_percentage);
+    ClassDB::bind_method(D_METHOD("set_scrubbing", "enabled"), &MPVPlayer::set_scrubbing);
+    ClassDB::bind_method(D_METHOD("is_scrubbing"), &MPVPlayer::is_scrubbing);
+    ClassDB::bind_method(D_METHOD("set_keyframe_index_enabled", "enabled"), &MPVPlayer::set_keyframe_index_enabled);
+    ClassDB::bind_method(D_METHOD("get_keyframe_index_enabled"), &MPVPlayer::get_keyframe_index_enabled);
+    ClassDB::bind_method(D_METHOD("is_keyframe_index_ready"), &MPVPlayer::is_keyframe_index_ready);
+    ClassDB::bind_method(D_METHOD("get_keyframes"), &MPVPlayer::get_keyframes);
+    ClassDB::bind_method(D_METHOD("get_nearest_keyframe", "time"), &MPVPlayer::get_nearest_keyframe);
+    ClassDB::bind_method(D_METHOD("frame_step"), &MPVPlayer::frame_step);
+    ClassDB::bind_method(D_METHOD("frame_back_step"), &MPVPlayer::frame_back_step);
+    ClassDB::bind_method(D_METHOD("set_frame_cache_budget_mb", "megabytes"), &MPVPlayer::set_frame_cache_budget_mb);
+    ClassDB::bind_method(D_METHOD("get_frame_cache_budget_mb"), &MPVPlayer::get_frame_cache_budget_mb);
+    ClassDB::bind_method(D_METHOD("set_reverse_playback", "enabled"), &MPVPlayer::set_reverse_playback);
+    ClassDB::bind_method(D_METHOD("is_reverse_playback"), &MPVPlayer::is_reverse_playback);
+    ClassDB::bind_method(D_METHOD("get_frame_cache_stats"), &MPVPlayer::get_frame_cache_stats);
     ClassDB::bind_method(D_METHOD("add_subtitle_file", "path", "title", "lang"), &MPVPlayer::add_subtitle_file, DEFVAL(""), DEFVAL(""));
 
     ClassDB::bind_method(D_METHOD("set_time_pos", "pos"), &MPVPlayer::set_time_pos);
     ClassDB::bind_method(D_METHOD("set_resolution", "new_width", "new_height"), &MPVPlayer::set_resolution);
+    ClassDB::bind_method(D_METHOD("set_auto_resolution", "enabled"), &MPVPlayer::set_auto_resolution);
+    ClassDB::bind_method(D_METHOD("get_auto_resolution"), &MPVPlayer::get_auto_resolution);
+    ClassDB::bind_method(D_METHOD("set_max_render_size", "size"), &MPVPlayer::set_max_render_size);
+    ClassDB::bind_method(D_METHOD("get_max_render_size"), &MPVPlayer::get_max_render_size);
+    ClassDB::bind_method(D_METHOD("set_render_at_display_size", "enabled"), &MPVPlayer::set_render_at_display_size);
+    ClassDB::bind_method(D_METHOD("get_render_at_display_size"), &MPVPlayer::get_render_at_display_size);
+    ClassDB::bind_method(D_METHOD("set_display_size_hint", "size"), &MPVPlayer::set_display_size_hint);
+    ClassDB::bind_method(D_METHOD("get_display_size_hint"), &MPVPlayer::get_display_size_hint);
+    ClassDB::bind_method(D_METHOD("set_readback_buffer_count", "count"), &MPVPlayer::set_readback_buffer_count);
+    ClassDB::bind_method(D_METHOD("get_readback_buffer_count"), &MPVPlayer::get_readback_buffer_count);
+    ClassDB::bind_method(D_METHOD("get_readback_latency"), &MPVPlayer::get_readback_latency);
+    ClassDB::bind_method(D_METHOD("get_render_backend"), &MPVPlayer::get_render_backend);
+    ClassDB::bind_method(D_METHOD("get_render_stats"), &MPVPlayer::get_render_stats);
+    ClassDB::bind_static_method("MPVPlayer", D_METHOD("get_render_backend_opengl"), &MPVPlayer::get_render_backend_opengl);
+    ClassDB::bind_static_method("MPVPlayer", D_METHOD("get_render_backend_software"), &MPVPlayer::get_render_backend_software);
+    ClassDB::bind_static_method("MPVPlayer", D_METHOD("benchmark_stream", "path"), &MPVPlayer::benchmark_stream);
     ClassDB::bind_method(D_METHOD("set_target_texture_rect", "rect"), &MPVPlayer::set_target_texture_rect);
     ClassDB::bind_method(D_METHOD("get_audio_tracks"), &MPVPlayer::get_audio_tracks);
     ClassDB::bind_method(D_METHOD("get_subtitle_tracks"), &MPVPlayer::get_subtitle_tracks);
+    ClassDB::bind_method(D_METHOD("get_video_tracks"), &MPVPlayer::get_video_tracks);
+    ClassDB::bind_method(D_METHOD("get_track_list_version"), &MPVPlayer::get_track_list_version);
     ClassDB::bind_method(D_METHOD("set_aspect_ratio", "ratio"), &MPVPlayer::set_aspect_ratio);
     ClassDB::bind_method(D_METHOD("set_playback_speed", "speed"), &MPVPlayer::set_playback_speed);
     ClassDB::bind_method(D_METHOD("set_repeat_file", "value"), &MPVPlayer::set_repeat_file);
@@ -53,6 +99,7 @@ void MPVPlayer::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_time_pos"), &MPVPlayer::get_time_pos);
     ClassDB::bind_method(D_METHOD("get_duration"), &MPVPlayer::get_duration);
     ClassDB::bind_method(D_METHOD("get_percentage_pos"), &MPVPlayer::get_percentage_pos);
+    ClassDB::bind_method(D_METHOD("get_state"), &MPVPlayer::get_state);
 
     
     // Getters
@@ -70,6 +117,7 @@ void MPVPlayer::_bind_methods() {
 
 
     // Register signals
+    ADD_SIGNAL(MethodInfo("initialized", PropertyInfo(Variant::BOOL, "ok")));
     ADD_SIGNAL(MethodInfo("texture_updated", PropertyInfo(Variant::OBJECT, "texture", PROPERTY_HINT_RESOURCE_TYPE, "Texture2D")));
     ADD_SIGNAL(MethodInfo("time_changed", PropertyInfo(Variant::FLOAT, "time_pos")));
 
@@ -77,14 +125,25 @@ void MPVPlayer::_bind_methods() {
     ADD_SIGNAL(MethodInfo("buffering_ended"));
 
     ADD_SIGNAL(MethodInfo("subtitle_changed", PropertyInfo(Variant::STRING, "text")));
+    ADD_SIGNAL(MethodInfo("seek_completed", PropertyInfo(Variant::FLOAT, "pos")));
+    ADD_SIGNAL(MethodInfo("keyframe_index_ready", PropertyInfo(Variant::INT, "count")));
 
     // Loading signals
     ADD_SIGNAL(MethodInfo("loading_started"));
     ADD_SIGNAL(MethodInfo("loading_finished"));
+    ADD_SIGNAL(MethodInfo("load_started", PropertyInfo(Variant::INT, "request_id")));
+    ADD_SIGNAL(MethodInfo("load_failed", PropertyInfo(Variant::INT, "request_id"), PropertyInfo(Variant::STRING, "error")));
+
+    // Playlist signals
+    ADD_SIGNAL(MethodInfo("playlist_item_changed", PropertyInfo(Variant::INT, "index")));
 }
 
 // ==================== Helper Methods ====================
 
+Dictionary MPVPlayer::benchmark_stream(const String& path) {
+    return GodotStream::benchmark(path);
+}
+
 double MPVPlayer::get_property_double(const char* name, double default_value) const {
     if (!mpv) return default_value;
 
@@ -129,13 +188,141 @@ bool MPVPlayer::get_property_bool(const char* name, bool default_value) const {
     return value != 0;
 }
 
+// ==================== Playback State Snapshot ====================
+
+void MPVPlayer::publish_state(const PlaybackState& state) {
+    uint64_t words[STATE_WORD_COUNT];
+    memcpy(words, &state, sizeof(words));
+
+    // Single writer seqlock: the sequence is odd while the words are being replaced
+    uint32_t sequence = state_sequence.load(std::memory_order_relaxed);
+    state_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < STATE_WORD_COUNT; i++) {
+        state_words[i].store(words[i], std::memory_order_relaxed);
+    }
+    state_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+MPVPlayer::PlaybackState MPVPlayer::read_state() const {
+    uint64_t words[STATE_WORD_COUNT];
+    uint32_t before;
+    uint32_t after;
+
+    // Retry if the event thread published in the middle of the copy, which is rare and short
+    do {
+        before = state_sequence.load(std::memory_order_acquire);
+        for (size_t i = 0; i < STATE_WORD_COUNT; i++) {
+            words[i] = state_words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = state_sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    PlaybackState state;
+    memcpy(&state, words, sizeof(state));
+    return state;
+}
+
+// ==================== Property Queue ====================
+
+// mpv property names, indexed by QueuedProperty
+static const char* const QUEUED_PROPERTY_NAMES[] = {
+    "pause",
+    "volume",
+    "speed",
+    "aid",
+    "sid",
+    "sub-delay",
+    "video-aspect-override",
+    "loop-file",
+    "playlist-pos",
+    "loop-playlist"
+};
+
+void MPVPlayer::queue_property_double(QueuedProperty property, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    queue_property_int(property, (int64_t)bits);
+}
+
+void MPVPlayer::queue_property_int(QueuedProperty property, int64_t value) {
+    // Publish the value before its dirty bit, the flush reads them in the opposite order
+    queued_values[property].store((uint64_t)value, std::memory_order_relaxed);
+    queued_mask.fetch_or(1u << property, std::memory_order_release);
+}
+
+void MPVPlayer::flush_queued_properties() {
+    // This method runs on the main thread
+    uint32_t mask = queued_mask.exchange(0, std::memory_order_acquire);
+    if (mask == 0 || !mpv) {
+        return;
+    }
+
+    for (int property = 0; property < QUEUED_PROPERTY_COUNT; property++) {
+        if (!(mask & (1u << property))) {
+            continue;
+        }
+
+        const char* name = QUEUED_PROPERTY_NAMES[property];
+        uint64_t bits = queued_values[property].load(std::memory_order_relaxed);
+
+        // mpv copies the value, so stack storage is fine for the async call
+        switch (property) {
+            case QUEUED_PAUSE: {
+                int flag = bits != 0 ? 1 : 0;
+                mpv_set_property_async(mpv, 0, name, MPV_FORMAT_FLAG, &flag);
+                break;
+            }
+            case QUEUED_PLAYLIST_POS: {
+                int64_t index = (int64_t)bits;
+                mpv_set_property_async(mpv, 0, name, MPV_FORMAT_INT64, &index);
+                break;
+            }
+            case QUEUED_LOOP_PLAYLIST: {
+                const char* choice = bits != 0 ? "inf" : "no";
+                mpv_set_property_async(mpv, 0, name, MPV_FORMAT_STRING, &choice);
+                break;
+            }
+            case QUEUED_AID:
+            case QUEUED_SID: {
+                int64_t id = (int64_t)bits;
+                if (id > 0) {
+                    mpv_set_property_async(mpv, 0, name, MPV_FORMAT_INT64, &id);
+                } else {
+                    const char* choice = id == 0 ? "no" : "auto";
+                    mpv_set_property_async(mpv, 0, name, MPV_FORMAT_STRING, &choice);
+                }
+                break;
+            }
+            case QUEUED_LOOP_FILE: {
+                CharString value;
+                {
+                    std::lock_guard<std::mutex> lock(queued_string_mutex);
+                    value = queued_loop_file.utf8();
+                }
+                const char* data = value.get_data();
+                mpv_set_property_async(mpv, 0, name, MPV_FORMAT_STRING, &data);
+                break;
+            }
+            default: {
+                double value;
+                memcpy(&value, &bits, sizeof(value));
+                mpv_set_property_async(mpv, 0, name, MPV_FORMAT_DOUBLE, &value);
+                break;
+            }
+        }
+    }
+}
+
 // Static callback for MPV render updates
 void MPVPlayer::on_mpv_render_update(void* ctx) {
     MPVPlayer* instance = static_cast<MPVPlayer*>(ctx);
     if (instance) {
         // Don't call any Godot functions from this callback
-        // Just set the flag and let the main thread handle it
+        // Just set the flag and wake the render thread
         instance->frame_available.store(true);
+        instance->wake_render_thread();
     }
 }
 
@@ -153,12 +340,11 @@ MPVPlayer::MPVPlayer() :
     mpv_ctx(nullptr),
     fbo(0),
     texture(0),
-    width(1920),
-    height(1080),
+    width(0),
+    height(0),
     target_texture_rect(nullptr),
     running(false),
     frame_available(false),
-    texture_needs_update(false),
     has_new_frame(false),
     is_streaming(false),
 	native_subtitles_enabled(false),
@@ -171,127 +357,263 @@ MPVPlayer::MPVPlayer() :
     egl_context(EGL_NO_CONTEXT),
     #endif
     is_buffering(false) {
-    
-    g_instance = this;
-    
-    // Initialize image with default data to avoid "empty image" errors
-    frame_image.instantiate();
-    frame_image->create(width, height, false, Image::FORMAT_RGBA8);
-    
-    // Fill with black pixels
-    PackedByteArray initial_data;
-    initial_data.resize(width * height * 4);
-    for (int i = 0; i < initial_data.size(); i += 4) {
-        initial_data.set(i, 0);     // R
-        initial_data.set(i + 1, 0); // G
-        initial_data.set(i + 2, 0); // B
-        initial_data.set(i + 3, 255); // A (fully opaque)
-    }
-    frame_image->set_data(width, height, false, Image::FORMAT_RGBA8, initial_data);
-    
-    // Create texture from the initialized image
-    frame_texture = ImageTexture::create_from_image(frame_image);
-    
-    // Initialize pixel data buffer
-    pixel_data.resize(width * height * 4);
-    pending_frame_data.resize(width * height * 4);
+    // Nothing is allocated until the render thread knows the video size, so instancing
+    // (and opening a scene in the editor) stays cheap
+
+    // Getters read the defaults until mpv reports the real values
+    publish_state(event_state);
 }
 
 MPVPlayer::~MPVPlayer() {
-    // Stop the render thread
-    if (running.load()) {
-        running.store(false);
-        if (render_thread.joinable()) {
-            render_thread.join();
+    // Normally already done by NOTIFICATION_PREDELETE
+    shutdown();
+}
+
+void MPVPlayer::_notification(int p_what) {
+    switch (p_what) {
+        case NOTIFICATION_PREDELETE: {
+            shutdown();
+            break;
         }
     }
-    
-    // Clean up MPV resources
+}
+
+void MPVPlayer::shutdown() {
+    if (is_shut_down) {
+        return;
+    }
+    is_shut_down = true;
+
+    // Both threads only touch this object, they have to be gone before it is. The render
+    // thread leaves its GL context released so the reaper can make it current.
+    stop_render_thread();
+    stop_event_thread();
+
+    // mpv outlives this object on the reaper thread, make sure it can't call back into it
     if (mpv_ctx) {
-        mpv_render_context_free(mpv_ctx);
-        mpv_ctx = nullptr;
+        mpv_render_context_set_update_callback(mpv_ctx, nullptr, nullptr);
+    }
+
+    // Everything that can block (render context, mpv core, EGL teardown) is destroyed by the reaper
+    PlayerResources resources;
+    resources.mpv = mpv;
+    resources.render_context = mpv_ctx;
+    resources.uses_gl = render_backend != RENDER_BACKEND_SOFTWARE;
+    resources.fbo = fbo;
+    resources.texture = texture;
+    for (const ReadbackSlot& slot : readback_slots) {
+        if (slot.pbo != 0) {
+            resources.buffers.push_back(slot.pbo);
+        }
+        if (slot.fence) {
+            resources.fences.push_back(slot.fence);
+        }
     }
-    
-    if (mpv) {
-        mpv_terminate_destroy(mpv);
-        mpv = nullptr;
+    readback_slots.clear();
+    readback_pending = 0;
+    mpv = nullptr;
+    mpv_ctx = nullptr;
+    fbo = 0;
+    texture = 0;
+
+    #ifndef __APPLE__
+    resources.egl_display = egl_display;
+    resources.egl_surface = egl_surface;
+    resources.egl_context = egl_context;
+    egl_display = EGL_NO_DISPLAY;
+    egl_surface = EGL_NO_SURFACE;
+    egl_context = EGL_NO_CONTEXT;
+    #endif
+
+    PlayerReaper::get_singleton().reap(std::move(resources));
+}
+
+// Shrink (w, h) to fit inside limit while keeping the aspect ratio, a zero limit component is ignored
+static void fit_render_size(int& w, int& h, const Vector2i& limit) {
+    if (limit.x > 0 && w > limit.x) {
+        h = std::max(1, (int)((int64_t)h * limit.x / w));
+        w = limit.x;
     }
-    
-    // Clean up OpenGL resources
-    if (fbo != 0) {
-        glDeleteFramebuffers(1, &fbo);
-        fbo = 0;
+    if (limit.y > 0 && h > limit.y) {
+        w = std::max(1, (int)((int64_t)w * limit.y / h));
+        h = limit.y;
     }
-    
-    if (texture != 0) {
-        glDeleteTextures(1, &texture);
-        texture = 0;
+}
+
+void MPVPlayer::set_resolution(int new_width, int new_height) {
+    if (new_width <= 0 || new_height <= 0) {
+        ERR_PRINT("Invalid resolution");
+        return;
     }
-    
-    // Reset static instance
-    if (g_instance == this) {
-        g_instance = nullptr;
+
+    // An explicit resolution overrides tracking the video size
+    {
+        std::lock_guard<std::mutex> lock(render_size_mutex);
+        auto_resolution = false;
     }
+    request_render_size(new_width, new_height);
 }
 
-void MPVPlayer::_notification(int p_what) {
-    switch (p_what) {
-        case NOTIFICATION_PREDELETE: {
-            // Stop the render thread
-            if (running.load()) {
-                running.store(false);
-                if (render_thread.joinable()) {
-                    render_thread.join();
-                }
-            }
-            
-            // Clean up MPV resources
-            if (mpv_ctx) {
-                mpv_render_context_free(mpv_ctx);
-                mpv_ctx = nullptr;
-            }
-            
-            if (mpv) {
-                mpv_terminate_destroy(mpv);
-                mpv = nullptr;
-            }
-            #ifndef __APPLE__
-            // Clean up OpenGL resources
-            if (egl_display != EGL_NO_DISPLAY) {
-                if (egl_context != EGL_NO_CONTEXT) {
-                    eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
-                    eglDestroyContext(egl_display, egl_context);
-                    egl_context = EGL_NO_CONTEXT;
-                }
-                
-                if (egl_surface != EGL_NO_SURFACE) {
-                    eglDestroySurface(egl_display, egl_surface);
-                    egl_surface = EGL_NO_SURFACE;
-                }
-                
-                eglTerminate(egl_display);
-                egl_display = EGL_NO_DISPLAY;
-            }
-            #endif
-            // Clean up OpenGL resources
-            if (fbo != 0) {
-                glDeleteFramebuffers(1, &fbo);
-                fbo = 0;
-            }
-            
-            if (texture != 0) {
-                glDeleteTextures(1, &texture);
-                texture = 0;
+void MPVPlayer::set_auto_resolution(bool enabled) {
+    {
+        std::lock_guard<std::mutex> lock(render_size_mutex);
+        auto_resolution = enabled;
+    }
+    update_render_size();
+}
+
+bool MPVPlayer::get_auto_resolution() {
+    std::lock_guard<std::mutex> lock(render_size_mutex);
+    return auto_resolution;
+}
+
+void MPVPlayer::set_max_render_size(Vector2i size) {
+    {
+        std::lock_guard<std::mutex> lock(render_size_mutex);
+        max_render_size = size;
+    }
+    update_render_size();
+}
+
+Vector2i MPVPlayer::get_max_render_size() {
+    std::lock_guard<std::mutex> lock(render_size_mutex);
+    return max_render_size;
+}
+
+void MPVPlayer::set_render_at_display_size(bool enabled) {
+    {
+        std::lock_guard<std::mutex> lock(render_size_mutex);
+        render_at_display_size = enabled;
+    }
+
+    if (enabled) {
+        update_display_size_limit();
+    }
+    update_render_size();
+}
+
+bool MPVPlayer::get_render_at_display_size() {
+    std::lock_guard<std::mutex> lock(render_size_mutex);
+    return render_at_display_size;
+}
+
+void MPVPlayer::set_display_size_hint(Vector2i size) {
+    display_size_hint = Vector2i(std::max(size.x, 0), std::max(size.y, 0));
+    if (render_at_display_size) {
+        update_display_size_limit();
+    }
+}
+
+Vector2i MPVPlayer::get_display_size_hint() {
+    return display_size_hint;
+}
+
+Vector2i MPVPlayer::measure_display_size() {
+    if (!target_texture_rect) {
+        return display_size_hint;
+    }
+
+    // Hidden rects keep the last size, so showing them again does not start with a blurry frame
+    if (!target_texture_rect->is_visible_in_tree()) {
+        return display_size_limit;
+    }
+
+    // Canvas transform (node scale, camera zoom) times the viewport's stretch/content scale
+    Vector2 scale = target_texture_rect->get_global_transform_with_canvas().get_scale().abs();
+    Viewport* viewport = target_texture_rect->get_viewport();
+    if (viewport) {
+        scale = scale * viewport->get_final_transform().get_scale().abs();
+    }
+
+    // Local size: get_global_rect() already includes the node scale
+    Vector2 size = target_texture_rect->get_size() * scale;
+    return Vector2i((int)std::ceil(size.x), (int)std::ceil(size.y));
+}
+
+void MPVPlayer::update_display_size_limit() {
+    // This method runs on the main thread
+    Vector2i limit = measure_display_size();
+
+    {
+        std::lock_guard<std::mutex> lock(render_size_mutex);
+        if (limit == display_size_limit) {
+            return;
+        }
+
+        // Hysteresis: grow as soon as the target is noticeably larger, but only shrink once it is
+        // well below the current size, so animated or moving targets do not reallocate every frame
+        if (limit.x > 0 && limit.y > 0 && display_size_limit.x > 0 && display_size_limit.y > 0) {
+            double ratio = std::max((double)limit.x / display_size_limit.x, (double)limit.y / display_size_limit.y);
+            if (ratio <= 1.1 && ratio >= 0.75) {
+                return;
             }
-            
-            break;
         }
+        display_size_limit = limit;
     }
+    update_render_size();
 }
 
-void MPVPlayer::set_resolution(int new_width, int new_height) {
-    this->width = new_width;
-    this->height = new_height;
+void MPVPlayer::update_render_size() {
+    // Called from the main thread (setters) and the event thread (video reconfig)
+    std::lock_guard<std::mutex> lock(render_size_mutex);
+
+    if (!auto_resolution || video_width <= 0 || video_height <= 0) {
+        return;
+    }
+
+    int new_width = video_width;
+    int new_height = video_height;
+    fit_render_size(new_width, new_height, max_render_size);
+    if (render_at_display_size) {
+        fit_render_size(new_width, new_height, display_size_limit);
+    }
+
+    request_render_size(new_width, new_height);
+}
+
+void MPVPlayer::request_render_size(int new_width, int new_height) {
+    requested_render_size.store(((uint64_t)new_width << 32) | (uint32_t)new_height);
+    wake_render_thread();
+}
+
+void MPVPlayer::apply_render_size() {
+    // This method runs on the render thread
+    uint64_t packed = requested_render_size.exchange(0);
+    if (packed == 0) {
+        return;
+    }
+
+    int new_width = (int)(packed >> 32);
+    int new_height = (int)(packed & 0xffffffff);
+    if (new_width == width.load() && new_height == height.load()) {
+        return;
+    }
+
+    width.store(new_width);
+    height.store(new_height);
+
+    if (texture != 0) {
+        // The first size also gives the FBO attachment its storage
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, new_width, new_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            UtilityFunctions::print("ERROR: Framebuffer is not complete: ", status);
+        }
+
+        // Frames still in flight have the old size and are dropped
+        allocate_readback_buffers();
+    }
+
+    // Redraw the current frame at the new size
+    frame_pending.store(true);
+
+    if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
+        UtilityFunctions::print("Render size changed to ", new_width, "x", new_height);
 }
 
 void MPVPlayer::set_target_texture_rect(TextureRect* rect) {
@@ -303,9 +625,152 @@ void MPVPlayer::set_target_texture_rect(TextureRect* rect) {
     }
 }
 
-bool MPVPlayer::initialize() {
+bool MPVPlayer::initialize(int backend) {
+    if (is_initializing()) {
+        ERR_PRINT("MPV is already being initialized by initialize_async");
+        return false;
+    }
+
     if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
     UtilityFunctions::print("Starting MPV player initialization");
+
+    if (!create_player(backend)) {
+        // Free what was created in this thread's context, and detach it so the reaper can bind it
+        if ((mpv_ctx || fbo != 0) && make_gl_current()) {
+            destroy_render_context();
+        }
+        release_gl_current();
+        return false;
+    }
+    
+    // From here on the GL context belongs to the render thread, detach it from this one
+    release_gl_current();
+    start_render_thread();
+    
+    if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
+    UtilityFunctions::print("MPV player initialized");
+    return true;
+}
+
+void MPVPlayer::initialize_async(int backend) {
+    if (is_initializing() || running.load() || mpv) {
+        ERR_PRINT("MPV is already initialized");
+        return;
+    }
+
+    if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
+    UtilityFunctions::print("Starting asynchronous MPV player initialization");
+
+    // The thread that builds the player becomes its render thread: the GL context is created,
+    // made current, used and destroyed on that one thread and never changes hands
+    async_init_state.store(ASYNC_INIT_PENDING);
+    running.store(true);
+    render_thread = std::thread(&MPVPlayer::initialize_and_render, this, backend);
+}
+
+bool MPVPlayer::is_initializing() const {
+    return async_init_state.load(std::memory_order_acquire) == ASYNC_INIT_PENDING;
+}
+
+void MPVPlayer::initialize_and_render(int backend) {
+    // This method runs on the render thread
+    bool ok = create_player(backend);
+
+    if (!ok) {
+        // Free whatever was created in this thread's context before the main thread takes over cleanup
+        if ((mpv_ctx || fbo != 0) && make_gl_current()) {
+            destroy_render_context();
+        }
+        release_gl_current();
+        running.store(false);
+    }
+
+    // Everything create_player wrote is visible to the main thread once it sees the new state
+    async_init_state.store(ok ? ASYNC_INIT_SUCCEEDED : ASYNC_INIT_FAILED, std::memory_order_release);
+
+    if (ok) {
+        if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
+        UtilityFunctions::print("MPV player initialized");
+        render_loop();
+    }
+}
+
+bool MPVPlayer::is_initialized() const {
+    return !is_initializing() && running.load();
+}
+
+int64_t MPVPlayer::get_init_time_usec() const {
+    return init_time_usec.load();
+}
+
+void MPVPlayer::reset_for_reuse() {
+    // This method runs on the main thread
+    if (!mpv) {
+        return;
+    }
+
+    const char* stop_cmd[] = {"stop", nullptr};
+    mpv_command_async(mpv, 0, stop_cmd);
+
+    seek_pending = false;
+    scrubbing = false;
+    has_scrub_target = false;
+    keyframe_index.reset();
+    keyframe_index_enabled = false;
+    set_frame_cache_budget_mb(0);
+
+    // Drop writes the previous user queued but never flushed, then restore mpv's defaults for
+    // everything the setters can change. Per-file load options reset themselves with each load.
+    queued_mask.store(0);
+    static const char* const DEFAULT_PROPERTIES[][2] = {
+        {"pause", "no"},
+        {"volume", "100"},
+        {"speed", "1"},
+        {"sub-delay", "0"},
+        {"aid", "auto"},
+        {"sid", "auto"},
+        {"video-aspect-override", "-1"},
+        {"loop-file", "no"},
+        {"loop-playlist", "no"},
+        {"sub-visibility", "yes"}
+    };
+    for (const auto& property : DEFAULT_PROPERTIES) {
+        const char* value = property[1];
+        mpv_set_property_async(mpv, 0, property[0], MPV_FORMAT_STRING, &value);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(render_size_mutex);
+        auto_resolution = true;
+        max_render_size = Vector2i();
+        render_at_display_size = false;
+        display_size_limit = Vector2i();
+    }
+    display_size_hint = Vector2i();
+    target_texture_rect = nullptr;
+
+    // The next user gets its own texture with the next frame, the previous one keeps showing its last frame
+    frame_exchange.fetch_and(FRAME_SLOT_INDEX_MASK, std::memory_order_acq_rel);
+    frame_texture.unref();
+    {
+        std::lock_guard<std::mutex> lock(event_mutex);
+        event_queue.clear();
+    }
+
+    // Main-thread state derived from the previous user's events
+    last_playlist_pos = -1;
+    is_buffering = false;
+
+    is_streaming = false;
+    native_subtitles_enabled = false;
+    last_subtitle_text = "";
+    frame_count = 0;
+    had_visible_content = false;
+}
+
+bool MPVPlayer::create_player(int backend) {
+    auto init_start = std::chrono::steady_clock::now();
+    render_backend = backend == RENDER_BACKEND_SOFTWARE ? RENDER_BACKEND_SOFTWARE : RENDER_BACKEND_OPENGL;
     
     // Create MPV instance
     mpv = mpv_create();
@@ -316,9 +781,15 @@ bool MPVPlayer::initialize() {
     
     // Set basic MPV options
     mpv_set_option_string(mpv, "vo", "libmpv");
-    mpv_set_option_string(mpv, "hwdec", "auto-safe");
+    // The software renderer needs decoded frames in system memory
+    mpv_set_option_string(mpv, "hwdec", render_backend == RENDER_BACKEND_SOFTWARE ? "auto-copy-safe" : "auto-safe");
     mpv_set_option_string(mpv, "profile", "fast");
     mpv_set_option_string(mpv, "video-sync", "display");
+
+    // Playlist items follow each other without a gap: the next one is opened while the current
+    // one plays, and the audio output stays open across the transition
+    mpv_set_option_string(mpv, "prefetch-playlist", "yes");
+    mpv_set_option_string(mpv, "gapless-audio", "yes");
     
     // Set network-related options for better HTTP streaming support
     mpv_set_option_string(mpv, "network-timeout", "15"); // 15 seconds timeout
@@ -336,6 +807,9 @@ bool MPVPlayer::initialize() {
         UtilityFunctions::print("Failed to initialize MPV: ", mpv_error_string(init_result));
         return false;
     }
+
+    // res:// and user:// paths are read through Godot, so files inside exported packs play too
+    GodotStream::register_protocols(mpv);
     
     // // Set up property observation for debugging
     // if (debug_level == DEBUG_FULL) {
@@ -344,100 +818,198 @@ bool MPVPlayer::initialize() {
     //     mpv_observe_property(mpv, 0, "paused-for-cache", MPV_FORMAT_FLAG);
     // }
 
-    mpv_observe_property(mpv, 1, "time-pos", MPV_FORMAT_DOUBLE);
-    mpv_observe_property(mpv, 2, "paused-for-cache", MPV_FORMAT_FLAG);
-    mpv_observe_property(mpv, 3, "core-idle", MPV_FORMAT_FLAG);
-    mpv_observe_property(mpv, 4, "sub-text", MPV_FORMAT_STRING);
-
-    // Initialize OpenGL rendering
-    if (!initialize_gl()) {
-        UtilityFunctions::print("Failed to initialize OpenGL");
-        return false;
-    }
-    
-    // Set up MPV render context
-    mpv_opengl_init_params gl_init_params = {
-        .get_proc_address = MPVPlayer::get_proc_address_mpv,
-        .get_proc_address_ctx = nullptr
-    };
-    
-    mpv_render_param params[] = {
-        {MPV_RENDER_PARAM_API_TYPE, const_cast<char*>(MPV_RENDER_API_TYPE_OPENGL)},
-        {MPV_RENDER_PARAM_OPENGL_INIT_PARAMS, &gl_init_params},
-        {MPV_RENDER_PARAM_INVALID, nullptr}
-    };
-    
-    if (mpv_render_context_create(&mpv_ctx, mpv, params) < 0) {
-        UtilityFunctions::print("Failed to create MPV render context");
-        return false;
+    mpv_observe_property(mpv, OBSERVE_TIME_POS, "time-pos", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(mpv, OBSERVE_PAUSED_FOR_CACHE, "paused-for-cache", MPV_FORMAT_FLAG);
+    mpv_observe_property(mpv, OBSERVE_CORE_IDLE, "core-idle", MPV_FORMAT_FLAG);
+    mpv_observe_property(mpv, OBSERVE_SUB_TEXT, "sub-text", MPV_FORMAT_STRING);
+
+    // Mirrored into the playback state snapshot read by the getters
+    mpv_observe_property(mpv, OBSERVE_PAUSE, "pause", MPV_FORMAT_FLAG);
+    mpv_observe_property(mpv, OBSERVE_DURATION, "duration", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(mpv, OBSERVE_PERCENT_POS, "percent-pos", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(mpv, OBSERVE_VOLUME, "volume", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(mpv, OBSERVE_SPEED, "speed", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(mpv, OBSERVE_SUB_DELAY, "sub-delay", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(mpv, OBSERVE_PLAYLIST_POS, "playlist-pos", MPV_FORMAT_INT64);
+    mpv_observe_property(mpv, OBSERVE_PLAYLIST_COUNT, "playlist-count", MPV_FORMAT_INT64);
+    mpv_observe_property(mpv, OBSERVE_IDLE_ACTIVE, "idle-active", MPV_FORMAT_FLAG);
+
+    // Parsed into the track table on every change, the track getters never query mpv
+    mpv_observe_property(mpv, OBSERVE_TRACK_LIST, "track-list", MPV_FORMAT_NODE);
+
+    // Events are picked up by a dedicated thread instead of being polled every frame
+    start_event_thread();
+
+    if (render_backend == RENDER_BACKEND_SOFTWARE) {
+        // The software renderer needs neither EGL nor an FBO, it writes frames straight
+        // into the buffer handed to the main thread
+        mpv_render_param params[] = {
+            {MPV_RENDER_PARAM_API_TYPE, const_cast<char*>(MPV_RENDER_API_TYPE_SW)},
+            {MPV_RENDER_PARAM_INVALID, nullptr}
+        };
+
+        if (mpv_render_context_create(&mpv_ctx, mpv, params) < 0) {
+            UtilityFunctions::print("Failed to create MPV software render context");
+            return false;
+        }
+    } else {
+        // Initialize OpenGL rendering
+        if (!initialize_gl()) {
+            UtilityFunctions::print("Failed to initialize OpenGL");
+            return false;
+        }
+        
+        // Set up MPV render context
+        mpv_opengl_init_params gl_init_params = {
+            .get_proc_address = MPVPlayer::get_proc_address_mpv,
+            .get_proc_address_ctx = nullptr
+        };
+        
+        mpv_render_param params[] = {
+            {MPV_RENDER_PARAM_API_TYPE, const_cast<char*>(MPV_RENDER_API_TYPE_OPENGL)},
+            {MPV_RENDER_PARAM_OPENGL_INIT_PARAMS, &gl_init_params},
+            {MPV_RENDER_PARAM_INVALID, nullptr}
+        };
+        
+        if (mpv_render_context_create(&mpv_ctx, mpv, params) < 0) {
+            UtilityFunctions::print("Failed to create MPV render context");
+            return false;
+        }
     }
     
     // Set up render update callback
     if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
     UtilityFunctions::print("Setting up render update callback");
     mpv_render_context_set_update_callback(mpv_ctx, on_mpv_render_update, this);
-    
-    // We'll start the render thread in _ready to ensure all Godot objects are properly initialized
-    // This helps avoid thread safety issues
-    if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
-    UtilityFunctions::print("MPV player initialized");
+
+    init_time_usec.store(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - init_start).count());
     return true;
 }
 
 void MPVPlayer::_ready() {
-    // Start render thread
+    // The render thread is started by initialize() once the render context exists
+    start_render_thread();
+}
+
+void MPVPlayer::start_render_thread() {
+    // initialize_async's thread is already running, check that before touching mpv_ctx
+    if (running.load() || !mpv_ctx) {
+        return;
+    }
+
     running.store(true);
     render_thread = std::thread(&MPVPlayer::render_loop, this);
 }
 
-bool MPVPlayer::initialize_gl() {
-    if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
-    UtilityFunctions::print("Initializing OpenGL for MPV rendering");
-    #ifndef __APPLE__
-    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
-    if (display == EGL_NO_DISPLAY) {
-        UtilityFunctions::print("failed to init egl display");
+void MPVPlayer::stop_render_thread() {
+    running.store(false);
+    wake_render_thread();
+    if (render_thread.joinable()) {
+        render_thread.join();
     }
+}
 
-    if (!eglInitialize(display, nullptr, nullptr)) {
-        UtilityFunctions::print("failed to init egl");
+void MPVPlayer::wake_render_thread() {
+    // Taking the lock orders the flag update against the waiter's predicate check,
+    // so a wakeup can't slip in between the check and the wait
+    {
+        std::lock_guard<std::mutex> lock(render_mutex);
     }
+    render_cv.notify_one();
+}
 
-    const EGLint config_attribs[] = {
-    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
-    EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
-    EGL_RED_SIZE, 8,
-    EGL_GREEN_SIZE, 8,
-    EGL_BLUE_SIZE, 8,
-    EGL_ALPHA_SIZE, 8,
-    EGL_NONE
-    };
+bool MPVPlayer::make_gl_current() {
+    // The software backend has no GL context to bind
+    if (render_backend == RENDER_BACKEND_SOFTWARE) {
+        return true;
+    }
+
+    #ifndef __APPLE__
+    if (egl_display == EGL_NO_DISPLAY || egl_context == EGL_NO_CONTEXT) {
+        return false;
+    }
+    return eglMakeCurrent(egl_display, egl_surface, egl_surface, egl_context) == EGL_TRUE;
+    #else
+    return true;
+    #endif
+}
+
+void MPVPlayer::release_gl_current() {
+    #ifndef __APPLE__
+    if (egl_display == EGL_NO_DISPLAY) {
+        return;
+    }
+
+    // The thread that created the context gets back whatever it had current, e.g. the caller
+    // of a synchronous initialize(). Binding it replaces ours.
+    if (previous_egl_context != EGL_NO_CONTEXT) {
+        bool restored = eglMakeCurrent(previous_egl_display, previous_egl_draw, previous_egl_read, previous_egl_context) == EGL_TRUE;
+        previous_egl_context = EGL_NO_CONTEXT;
+        if (restored) {
+            return;
+        }
+    }
+    eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    #endif
+}
+
+void MPVPlayer::destroy_render_context() {
+    // Must be called with the GL context current
+    if (mpv_ctx) {
+        mpv_render_context_free(mpv_ctx);
+        mpv_ctx = nullptr;
+    }
+
+    free_readback_buffers();
 
-    EGLConfig config;
-    EGLint num_configs;
-    if (!eglChooseConfig(display, config_attribs, &config, 1, &num_configs)) {
-        UtilityFunctions::print("failed to apply egl config");
+    if (fbo != 0) {
+        glDeleteFramebuffers(1, &fbo);
+        fbo = 0;
     }
     
-    const EGLint pbuffer_attribs[] = {
-    EGL_WIDTH, 1,
-    EGL_HEIGHT, 1,
-    EGL_NONE
-    };
-    EGLSurface surface = eglCreatePbufferSurface(display, config, pbuffer_attribs);
+    if (texture != 0) {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+}
 
-    const EGLint context_attribs[] = {
-    EGL_CONTEXT_CLIENT_VERSION, 2,
-    EGL_NONE
-    };
-    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+bool MPVPlayer::initialize_gl() {
+    if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
+    UtilityFunctions::print("Initializing OpenGL for MPV rendering");
+    #ifndef __APPLE__
+    // The display and config are shared by all players, each player gets its own
+    // context in the shared group
+    EGLDisplayManager& egl = EGLDisplayManager::get_singleton();
+    if (!egl.acquire()) {
+        return false;
+    }
+    egl_display = egl.get_display();
+    egl_surface = egl.create_surface();
+    egl_context = egl.create_context();
+
+    if (egl_context == EGL_NO_CONTEXT) {
+        UtilityFunctions::print("could not create egl context");
+        return false;
+    }
+
+    previous_egl_context = eglGetCurrentContext();
+    previous_egl_display = eglGetCurrentDisplay();
+    previous_egl_draw = eglGetCurrentSurface(EGL_DRAW);
+    previous_egl_read = eglGetCurrentSurface(EGL_READ);
 
-    if (!eglMakeCurrent(display, surface, surface, context)) {
+    if (!eglMakeCurrent(egl_display, egl_surface, egl_surface, egl_context)) {
         UtilityFunctions::print("could not make egl context current");
+        return false;
     }
     
-    if (!gladLoadGLES2((GLADloadfunc)load_func)) {
-        UtilityFunctions::print("eglGetProcName failed");
+    if (!egl.load_gl()) {
+        return false;
+    }
+
+    // Pixel pack buffers, glMapBufferRange and fences are core in GLES 3.0
+    pbo_supported = egl.get_client_version() >= 3 && GLAD_GL_ES_VERSION_3_0 != 0;
+    if (!pbo_supported && readback_buffer_count > 0) {
+        UtilityFunctions::print("GLES 3 not available, falling back to synchronous frame readback");
     }
     #endif
     // Create FBO for rendering
@@ -454,23 +1026,10 @@ bool MPVPlayer::initialize_gl() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     
-    // Allocate texture storage
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    
-    // Attach texture to FBO
+    // Attach texture to FBO. Its storage, the readback buffers and the completeness check
+    // follow in apply_render_size once the video size is known.
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
     
-    // Check FBO status
-    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-    if (status != GL_FRAMEBUFFER_COMPLETE) {
-        UtilityFunctions::print("ERROR: Framebuffer is not complete: ", status);
-        return false;
-    }
-    
-    // Initialize pixel data buffer
-    pixel_data.resize(width * height * 4);
-    pending_frame_data.resize(width * height * 4);
-    
     // Unbind FBO
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
@@ -478,488 +1037,1849 @@ bool MPVPlayer::initialize_gl() {
     return true;
 }
 
+bool MPVPlayer::allocate_readback_buffers() {
+    free_readback_buffers();
+
+    int slot_count = readback_buffer_count.load();
+    if (!pbo_supported || slot_count <= 0 || width.load() <= 0) {
+        return false;
+    }
+
+    readback_slots.resize(slot_count);
+    for (ReadbackSlot& slot : readback_slots) {
+        glGenBuffers(1, &slot.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, width * height * 4, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
+        UtilityFunctions::print("Allocated ", slot_count, " readback buffers");
+    return true;
+}
+
+void MPVPlayer::free_readback_buffers() {
+    for (ReadbackSlot& slot : readback_slots) {
+        if (slot.fence) {
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+        if (slot.pbo != 0) {
+            glDeleteBuffers(1, &slot.pbo);
+            slot.pbo = 0;
+        }
+    }
+    readback_slots.clear();
+    readback_write_index = 0;
+    readback_pending = 0;
+}
+
+void MPVPlayer::queue_readback(double pts) {
+    // Must be called with our FBO bound
+    int slot_count = static_cast<int>(readback_slots.size());
+    ReadbackSlot& slot = readback_slots[readback_write_index];
+
+    // The ring is full and the oldest frame still hasn't landed: drop it rather than wait on the GPU
+    if (slot.fence) {
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        readback_pending--;
+        if(debug_level == DEBUG_FULL)
+            UtilityFunctions::print("Readback ring full, dropped a frame");
+    }
+
+    // With a pack buffer bound glReadPixels only queues the copy and returns immediately
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.issued_frame = render_frame_index;
+    slot.pts = pts;
+    // Make sure the fence is actually submitted, otherwise polling it could never succeed
+    glFlush();
+
+    readback_write_index = (readback_write_index + 1) % slot_count;
+    readback_pending++;
+}
+
+bool MPVPlayer::collect_readback() {
+    // Poll the in-flight readbacks from oldest to newest without blocking,
+    // only the newest completed one is copied out
+    int slot_count = static_cast<int>(readback_slots.size());
+    int ready_index = -1;
+
+    while (readback_pending > 0) {
+        int oldest = (readback_write_index - readback_pending + slot_count) % slot_count;
+        ReadbackSlot& slot = readback_slots[oldest];
+
+        GLenum wait_result = glClientWaitSync(slot.fence, 0, 0);
+        if (wait_result != GL_ALREADY_SIGNALED && wait_result != GL_CONDITION_SATISFIED) {
+            break;
+        }
+
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        readback_pending--;
+        ready_index = oldest;
+    }
+
+    if (ready_index < 0) {
+        return false;
+    }
+
+    ReadbackSlot& slot = readback_slots[ready_index];
+    size_t frame_size = static_cast<size_t>(width) * height * 4;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frame_size, GL_MAP_READ_BIT);
+    if (mapped) {
+        // The only copy left between the GPU and the ImageTexture upload
+        memcpy(get_back_frame(), mapped, frame_size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        publish_frame(slot.pts);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    int latency = static_cast<int>(render_frame_index - slot.issued_frame);
+    readback_latency_frames.store(latency);
+    if(debug_level == DEBUG_FULL)
+        UtilityFunctions::print("Readback latency: ", latency, " frame(s)");
+
+    return mapped != nullptr;
+}
+
+void MPVPlayer::set_readback_buffer_count(int count) {
+    if (count < 0) count = 0;
+    if (count > 8) count = 8;
+    readback_buffer_count.store(count);
+
+    // The render thread owns the GL context, it reallocates the ring before its next frame
+    readback_config_changed.store(true);
+    wake_render_thread();
+}
+
+int MPVPlayer::get_readback_buffer_count() const {
+    return readback_buffer_count;
+}
+
+int MPVPlayer::get_readback_latency() const {
+    return readback_latency_frames.load();
+}
+
+int MPVPlayer::get_render_backend() const {
+    return render_backend;
+}
+
+Dictionary MPVPlayer::get_render_stats() const {
+    Dictionary stats;
+    uint64_t frames = rendered_frame_count.load();
+    uint64_t total_usec = render_time_total_usec.load();
+
+    stats["backend"] = render_backend == RENDER_BACKEND_SOFTWARE ? "software" : "opengl";
+    stats["frames_rendered"] = (int64_t)frames;
+    stats["last_render_usec"] = (int64_t)last_render_time_usec.load();
+    stats["average_render_usec"] = frames > 0 ? (double)total_usec / (double)frames : 0.0;
+    stats["readback_latency_frames"] = readback_latency_frames.load();
+    stats["skipped_updates"] = (int64_t)skipped_update_count.load();
+    stats["repeated_frames"] = (int64_t)repeated_frame_count.load();
+    stats["swaps_reported"] = (int64_t)presented_frame_count.load();
+    stats["present_interval_usec"] = (int64_t)present_interval_usec.load();
+    return stats;
+}
+
 void MPVPlayer::render_loop() {
-    // This is a minimal render loop that only handles MPV render updates
-    // It avoids any direct OpenGL operations that might cause thread safety issues
-    
+    // All of mpv's rendering and the readback happen here with the GL context current,
+    // the main thread only uploads finished frames
+    if (!make_gl_current()) {
+        UtilityFunctions::print("ERROR: Render thread could not make the GL context current");
+        return;
+    }
+
     while (running.load()) {
+        {
+            // Sleep until mpv reports an update, a pending frame becomes due, Godot presents a frame
+            // or we're asked to stop. While readbacks are in flight we also wake up every millisecond
+            // to poll their fences.
+            std::unique_lock<std::mutex> lock(render_mutex);
+            auto has_work = [this] {
+                bool frame_due = frame_pending.load() && mpv_get_time_us(mpv) >= frame_due_usec;
+                bool can_render = frame_available.load() || frame_due;
+                bool can_resize = requested_render_size.load() != 0;
+                bool swap_presented = presented_frame_count.load() != reported_swap_count;
+                return !running.load() || can_render || can_resize || swap_presented || readback_config_changed.load();
+            };
+            if (readback_pending > 0) {
+                render_cv.wait_for(lock, std::chrono::milliseconds(1), has_work);
+            } else if (frame_pending.load() && frame_due_usec > mpv_get_time_us(mpv)) {
+                render_cv.wait_for(lock, std::chrono::microseconds(frame_due_usec - mpv_get_time_us(mpv)), has_work);
+            } else {
+                render_cv.wait(lock, has_work);
+            }
+        }
+
+        report_swaps();
+
+        if (readback_config_changed.exchange(false)) {
+            allocate_readback_buffers();
+        }
+
+        if (requested_render_size.load() != 0) {
+            apply_render_size();
+        }
+
+        // The update callback fires for more than new frames, only the FRAME flag means there is
+        // something to render, so faster-than-video game frames never re-render the same image
         if (frame_available.exchange(false)) {
-            texture_needs_update.store(true);
+            if (mpv_render_context_update(mpv_ctx) & MPV_RENDER_UPDATE_FRAME) {
+                frame_pending.store(true);
+                frame_due_usec = 0;
+                // The newest time-pos the event thread has seen, asking mpv here would block on its core
+                pending_frame_pts = read_state().time_pos;
+            } else {
+                skipped_update_count.fetch_add(1);
+            }
         }
-            
-            // Sleep to avoid busy waiting
-            // std::this_thread::sleep_for(std::chrono::milliseconds(16)); // ~60 FPS
+
+        if (frame_pending.load() && is_frame_due()) {
+            frame_pending.store(false);
+            if (render_backend == RENDER_BACKEND_SOFTWARE) {
+                render_frame_sw();
+            } else {
+                render_frame();
+            }
+        }
+
+        // Hand over the newest completed readback
+        if (readback_pending > 0) {
+            collect_readback();
         }
+    }
+
+    // The render context and GL objects are freed by the PlayerReaper, which needs the context
+    // to be current nowhere else
+    release_gl_current();
+}
+
+bool MPVPlayer::is_frame_due() {
+    // This method runs on the render thread
+    mpv_render_frame_info info = {};
+    mpv_render_param param = {MPV_RENDER_PARAM_NEXT_FRAME_INFO, &info};
+    if (mpv_render_context_get_info(mpv_ctx, param) < 0 || !(info.flags & MPV_RENDER_FRAME_INFO_PRESENT)) {
+        // Nothing queued, render anyway so redraws (e.g. after a resize) go through
+        frame_is_repeat = false;
+        return true;
+    }
+
+    frame_is_repeat = (info.flags & MPV_RENDER_FRAME_INFO_REPEAT) != 0;
+
+    // Redraws and untimed frames (paused, seeking) go out immediately. Timed frames are rendered
+    // one Godot frame ahead of their target time, so they are on screen by the frame they belong to
+    // instead of whenever the render thread happened to wake up.
+    if (info.flags & MPV_RENDER_FRAME_INFO_REDRAW || info.target_time <= 0) {
+        return true;
+    }
+
+    frame_due_usec = info.target_time - present_interval_usec.load();
+    return mpv_get_time_us(mpv) >= frame_due_usec;
+}
+
+void MPVPlayer::report_swaps() {
+    // This method runs on the render thread
+    // Each Godot frame counts as one swap, which is what video-sync=display times its frames against
+    uint64_t presented = presented_frame_count.load();
+    if (!mpv_ctx || presented == reported_swap_count) {
+        return;
+    }
+
+    // Only report once if several frames went by, a burst of swaps would look like a stall to mpv
+    reported_swap_count = presented;
+    mpv_render_context_report_swap(mpv_ctx);
+}
+
+void MPVPlayer::render_frame() {
+    // This method runs on the render thread
+    // Without a size there is no storage yet, apply_render_size asks for the redraw
+    if (!mpv_ctx || !fbo || width.load() <= 0) {
+        return;
+    }
+
+    auto render_start = std::chrono::steady_clock::now();
+
+    // Bind our FBO for rendering
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    
+    // Set up FBO for rendering
+    mpv_opengl_fbo mpv_fbo = {
+        .fbo = static_cast<int>(fbo),
+        .w = width,
+        .h = height,
+        .internal_format = 0
+    };
+    
+    // Rendering parameters, pacing is done by the render loop so mpv must never sleep in here
+    int block_for_target_time = 0;
+    mpv_render_param params[] = {
+        {MPV_RENDER_PARAM_OPENGL_FBO, &mpv_fbo},
+        {MPV_RENDER_PARAM_BLOCK_FOR_TARGET_TIME, &block_for_target_time},
+        {MPV_RENDER_PARAM_INVALID, nullptr}
+    };
+    
+    // Render frame to FBO
+    mpv_render_context_render(mpv_ctx, params);
+    render_frame_index++;
+    
+    // Make sure we're in the correct framebuffer
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    if (frame_is_repeat) {
+        // mpv still has to render a repeated frame to advance, but its pixels are already on screen
+        repeated_frame_count.fetch_add(1);
+    } else if (!readback_slots.empty()) {
+        // Frame k is copied into a pixel buffer while frame k+1 renders, it is picked up
+        // by collect_readback once its fence has signaled
+        queue_readback(pending_frame_pts);
+    } else {
+        // Read pixels - make sure we're reading RGBA data
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, get_back_frame());
+        publish_frame(pending_frame_pts);
+    }
+    
+    // Unbind our FBO to restore the default framebuffer
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - render_start).count();
+    last_render_time_usec.store(elapsed);
+    render_time_total_usec.fetch_add(elapsed);
+    rendered_frame_count.fetch_add(1);
+}
+
+void MPVPlayer::render_frame_sw() {
+    // This method runs on the render thread
+    if (!mpv_ctx || width.load() <= 0) {
+        return;
+    }
+
+    auto render_start = std::chrono::steady_clock::now();
+
+    int sw_size[2] = {width, height};
+    size_t sw_stride = static_cast<size_t>(width) * 4;
+    int block_for_target_time = 0;
+
+    // Repeated frames are rendered into the back slot too but never published, so they don't cost an upload
+    uint8_t* target = get_back_frame();
+
+    mpv_render_param params[] = {
+        {MPV_RENDER_PARAM_SW_SIZE, sw_size},
+        {MPV_RENDER_PARAM_SW_FORMAT, const_cast<char*>("rgb0")},
+        {MPV_RENDER_PARAM_SW_STRIDE, &sw_stride},
+        {MPV_RENDER_PARAM_SW_POINTER, target},
+        {MPV_RENDER_PARAM_BLOCK_FOR_TARGET_TIME, &block_for_target_time},
+        {MPV_RENDER_PARAM_INVALID, nullptr}
+    };
+
+    if (mpv_render_context_render(mpv_ctx, params) < 0) {
+        return;
+    }
+    render_frame_index++;
+
+    if (frame_is_repeat) {
+        repeated_frame_count.fetch_add(1);
+        return;
+    }
+
+    // rgb0 leaves the padding byte undefined, Godot reads it as alpha
+    size_t pixel_count = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < pixel_count; i++) {
+        target[i * 4 + 3] = 255;
+    }
+
+    publish_frame(pending_frame_pts);
+
+    uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - render_start).count();
+    last_render_time_usec.store(elapsed);
+    render_time_total_usec.fetch_add(elapsed);
+    rendered_frame_count.fetch_add(1);
+}
+
+uint8_t* MPVPlayer::get_back_frame() {
+    // This method runs on the render thread
+    Ref<Image>& image = frame_slots[back_slot];
+    int frame_width = width.load();
+    int frame_height = height.load();
+    if (image.is_null() || image->get_width() != frame_width || image->get_height() != frame_height) {
+        image = Image::create_empty(frame_width, frame_height, false, Image::FORMAT_RGBA8);
+    }
+    return image->ptrw();
+}
+
+void MPVPlayer::publish_frame(double pts) {
+    // This method runs on the render thread
+    frame_slot_pts[back_slot] = pts;
+    // The release half publishes the slot's pixels, the acquire half hands us the slot the main thread let go of
+    uint8_t previous = frame_exchange.exchange(static_cast<uint8_t>(back_slot) | FRAME_SLOT_FRESH, std::memory_order_acq_rel);
+    back_slot = previous & FRAME_SLOT_INDEX_MASK;
+    has_new_frame.store(true);
+}
+
+bool MPVPlayer::take_frame() {
+    // This method runs on the main thread
+    if (!(frame_exchange.load(std::memory_order_acquire) & FRAME_SLOT_FRESH)) {
+        return false;
+    }
+
+    uint8_t previous = frame_exchange.exchange(static_cast<uint8_t>(front_slot), std::memory_order_acq_rel);
+    front_slot = previous & FRAME_SLOT_INDEX_MASK;
+    return true;
 }
 
 void MPVPlayer::update_texture() {
     // This method is called from the main thread
     
-    // Check if there's new frame data available
-    if (texture_needs_update.load()) {
+    // Check if there's new frame data available. mpv_render_context_update belongs to the
+    // render thread, calling it here would swallow its FRAME flags.
+    if (take_frame()) {
         _update_texture_internal();
-    } else {
-        // Make sure MPV updates its internal state
-        if (mpv && mpv_ctx) {
-            mpv_render_context_update(mpv_ctx);
-        }
     }
 }
 
 void MPVPlayer::_update_texture_internal() {
-    // This method runs on the main thread
-    
-    // Create a new local image and update it with the pixel data
-    Ref<Image> new_image;
-    new_image.instantiate();
-    new_image->create(width, height, false, Image::FORMAT_RGBA8);
-    
-    {
-        std::lock_guard<std::mutex> lock(frame_mutex);
+    // This method runs on the main thread, with the newest frame in the front slot
+    upload_frame(frame_slots[front_slot]);
+}
 
-        new_image->set_data(width, height, false, Image::FORMAT_RGBA8, pending_frame_data);
+void MPVPlayer::upload_frame(const Ref<Image>& frame_image) {
+    // The frame size travels with the frame, the render size may already have moved on
+    int frame_width = frame_image->get_width();
+    int frame_height = frame_image->get_height();
+
+    if (frame_texture.is_null()) {
+        frame_texture.instantiate();
     }
-    
-    // Create a new texture from the image
-    Ref<ImageTexture> new_texture = ImageTexture::create_from_image(new_image);
-    
-    // Only update the reference if we successfully created a new texture
-    if (new_texture.is_valid()) {
-        frame_image = new_image;
-        frame_texture = new_texture;
 
+    // Only (re)allocate GPU storage when the frame size changes, otherwise upload in place.
+    // set_image keeps the texture RID, so the texture object stays stable for the whole file.
+    bool texture_reallocated = false;
+    if (frame_texture->get_width() != frame_width || frame_texture->get_height() != frame_height) {
+        frame_texture->set_image(frame_image);
+        texture_reallocated = true;
 
-        // Update the TextureRect if set
-        if (target_texture_rect) {
-            target_texture_rect->set_texture(frame_texture);
-        }
-        
-        // Add debug info to verify texture content
-        if(debug_level == DEBUG_FULL)
-            UtilityFunctions::print("Created texture with size: ", width, "x", height);
-        
-        // Emit signal for texture update (useful for 3D and SubViewport usage)
         if(debug_level == DEBUG_FULL)
-            UtilityFunctions::print("Emitting texture_updated signal");
-        emit_signal("texture_updated", frame_texture);
+            UtilityFunctions::print("Allocated texture with size: ", frame_width, "x", frame_height);
     } else {
-        UtilityFunctions::print("ERROR: Failed to create valid texture from image");
+        frame_texture->update(frame_image);
+    }
+
+    // The TextureRect keeps pointing at the same texture, only rebind it after a reallocation
+    if (texture_reallocated && target_texture_rect) {
+        target_texture_rect->set_texture(frame_texture);
     }
+
+    // Emit signal for texture update (useful for 3D and SubViewport usage)
+    if(debug_level == DEBUG_FULL)
+        UtilityFunctions::print("Emitting texture_updated signal");
+    emit_signal("texture_updated", frame_texture);
 }
 
 void MPVPlayer::_process(double delta) {
     // This method runs on the main thread
-    
-    // Check if we need to update the texture
-    if (texture_needs_update.load()) {
-        // Reset the flag at the beginning to avoid missing frames
-        texture_needs_update.store(false);
-        
-        // Perform all OpenGL operations on the main thread
-        if (mpv_ctx && fbo) {
-            // Bind our FBO for rendering
-            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-            
-            // Set up FBO for rendering
-            mpv_opengl_fbo mpv_fbo = {
-                .fbo = static_cast<int>(fbo),
-                .w = width,
-                .h = height,
-                .internal_format = 0
-            };
-            
-            // Rendering parameters
-            mpv_render_param params[] = {
-                {MPV_RENDER_PARAM_OPENGL_FBO, &mpv_fbo},
-                {MPV_RENDER_PARAM_INVALID, nullptr}
-            };
-            
-            // Render frame to FBO
-            int render_result = mpv_render_context_render(mpv_ctx, params);
-            
-            // Read pixels from FBO
-            {
-                std::lock_guard<std::mutex> lock(frame_mutex);
-                
-                // Make sure we're in the correct framebuffer
-                glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-                
-                // Don't clear the buffer as it would erase the MPV rendering
-                // glClear(GL_COLOR_BUFFER_BIT);
-                
-                // Read pixels - make sure we're reading RGBA data
-                glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixel_data.ptrw());
-                
-                uint8_t* data = (uint8_t*)pixel_data.ptrw();
-                
-                memcpy(pending_frame_data.ptrw(), pixel_data.ptr(), width * height * 4);
-                has_new_frame.store(true);
 
-            }
-            
-            // Unbind our FBO to restore the default framebuffer
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
-            
-            // Now update the texture with the new frame data
+    // Nothing but the render thread may touch mpv until initialize_async has finished
+    int init_state = async_init_state.load(std::memory_order_acquire);
+    if (init_state == ASYNC_INIT_PENDING) {
+        return;
+    }
+    if (init_state != ASYNC_INIT_IDLE) {
+        async_init_state.store(ASYNC_INIT_IDLE);
+        bool ok = init_state == ASYNC_INIT_SUCCEEDED;
+        if (!ok) {
+            // The render thread has already given up, collect it
+            stop_render_thread();
+        }
+        emit_signal("initialized", ok);
+    }
+    
+    // Upload the newest frame the render thread published, older unconsumed ones were already replaced.
+    // While a cached frame mpv isn't showing is on screen, mpv's frames only feed the frame cache.
+    if (take_frame()) {
+        if (jog_state != JOG_IDLE) {
+            capture_jog_frame();
+        } else if (jog_cursor < 0 || jog_cursor == jog_live) {
             _update_texture_internal();
         }
     }
+
+    count_presented_frame();
     
     // Handle any logging that was requested from the render thread
     if (has_new_frame.load()) {
         has_new_frame.store(false);
     }
     
-    // Make sure MPV updates its internal state
-    if (mpv) {
-        mpv_event* event = mpv_wait_event(mpv, 0);
-        double time_pos = 0.0;
-        double duration = 0.0;
-        while (event->event_id != MPV_EVENT_NONE) {
-            // Process MPV events
-            switch (event->event_id) {
-                case MPV_EVENT_FILE_LOADED:
-                    if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
-                        UtilityFunctions::print("File loaded successfully");
-                    
-                    // Reset frame counter and content flag when a new file is loaded
-                    frame_count = 0;
-                    had_visible_content = false;
+    if (render_at_display_size) {
+        update_display_size_limit();
+    }
 
-                    emit_signal("loading_finished");
-                    break;
-                    
-                case MPV_EVENT_PLAYBACK_RESTART:
-                    if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
-                        UtilityFunctions::print("Playback restarted");
-                    break;
+    // Send this frame's property writes, one per property however often the setters were called
+    flush_queued_properties();
 
-                    
-                case MPV_EVENT_END_FILE:
-                    {
-                        mpv_event_end_file* end_file = static_cast<mpv_event_end_file*>(event->data);
-                        
-                        // Always log errors
-                        if (end_file->reason == MPV_END_FILE_REASON_ERROR) {
-                            UtilityFunctions::print("ERROR: Playback failed with error code: ", end_file->error);
-                            
-                            // Get the error string
-                            const char* err_str = mpv_error_string(end_file->error);
-                            if (err_str) {
-                                UtilityFunctions::print("MPV Error: ", err_str);
-                            }
-                            
-                            // For streaming, try to provide more specific error information
-                            if (is_streaming) {
-                                UtilityFunctions::print("HTTP stream playback failed. Possible causes:");
-                                UtilityFunctions::print("- Network connectivity issues");
-                                UtilityFunctions::print("- Unsupported codec or format");
-                                UtilityFunctions::print("- Invalid URL or stream");
-                                
-                                // Try to get more diagnostic information
-                                char* media_title = nullptr;
-                                if (mpv_get_property(mpv, "media-title", MPV_FORMAT_STRING, &media_title) >= 0 && media_title) {
-                                    UtilityFunctions::print("Media title: ", media_title);
-                                    mpv_free(media_title);
-                                }
-                            }
-                        } else if (debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL) {
-                            // Log normal end-of-file events only if debug is enabled
-                            UtilityFunctions::print("Playback ended with reason: ", end_file->reason);
-                        }
-                    }
-                    break;
-                    
-                case MPV_EVENT_LOG_MESSAGE:
-                    if(debug_level == DEBUG_FULL) {
-                        mpv_event_log_message* msg = static_cast<mpv_event_log_message*>(event->data);
-                        UtilityFunctions::print("MPV Log [", msg->prefix, "]: ", msg->text);
-                    }
-                    break;
-                    
-                case MPV_EVENT_PROPERTY_CHANGE: {
-                    mpv_event_property *prop = static_cast<mpv_event_property *>(event->data);
-                    if (!prop || !prop->data) break;
-                    switch (event->reply_userdata)
-                    {
-                    case 1:
-                        time_pos = *static_cast<double *>(prop->data);
-                        call_deferred("emit_signal", "time_changed", time_pos);
-                        break;
-                    case 2: {
-                            bool paused_for_cache = *static_cast<int *>(prop->data) != 0;
-                            if (paused_for_cache && !is_buffering) {
-                                is_buffering = true;
-                                call_deferred("emit_signal", "buffering_started");
-                            } else if (!paused_for_cache && is_buffering) {
-                                is_buffering = false;
-                                call_deferred("emit_signal", "buffering_ended");
-							}
-                            break;
-                    }
-					case 3: {
-                           bool core_idle = *static_cast<int*>(prop->data);
-                           if (core_idle && !is_buffering) {
-                               is_buffering = true;
-                               call_deferred("emit_signal", "buffering_started");
-                           }
-                           else if (!core_idle && is_buffering) {
-                               is_buffering = false;
-                               call_deferred("emit_signal", "buffering_ended");
-                           }
-                           break;
-                    }
-                    case 4: {
-                        if (prop->format == MPV_FORMAT_STRING && prop->data) {
-                            char* sub_text = *static_cast<char**>(prop->data);
-                            if (sub_text != nullptr) {
-                                String subtitle_text = String::utf8(sub_text);
-                                // Only emit if text changed to avoid spam
-                                if (subtitle_text != last_subtitle_text) {
-                                    last_subtitle_text = subtitle_text;
-                                    call_deferred("emit_signal", "subtitle_changed", subtitle_text);
-                                }
-                            }
-                        }
-                        else {
-                            // No subtitle or subtitle cleared
-                            if (!last_subtitle_text.is_empty()) {
-                                last_subtitle_text = "";
-                                call_deferred("emit_signal", "subtitle_changed", String(""));
-                            }
-                        }
-                          }
-                    }
-                    break;
-                    }
-            }
-            
-            event = mpv_wait_event(mpv, 0);
+    // Emit signals for whatever the event thread decoded since the last frame
+    drain_events();
+
+    if (keyframe_index && !keyframe_index_reported && keyframe_index->is_ready()) {
+        keyframe_index_reported = true;
+        emit_signal("keyframe_index_ready", (int64_t)keyframe_index->get_times().size());
+    }
+
+    if (jog_cursor >= 0 || jog_pending_steps != 0) {
+        update_jog(delta);
+    }
+
+    // After draining, so a seek that just completed is followed by the newest target this frame
+    flush_pending_seek();
+}
+
+void MPVPlayer::count_presented_frame() {
+    // This method runs on the main thread
+    if (!mpv_ctx) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (last_present_time.time_since_epoch().count() != 0) {
+        int64_t interval = std::chrono::duration_cast<std::chrono::microseconds>(now - last_present_time).count();
+        interval = std::clamp<int64_t>(interval, 1000, 100000);
+        present_interval_usec.store((present_interval_usec.load() * 7 + interval) / 8);
+    }
+    last_present_time = now;
+    presented_frame_count.fetch_add(1);
+    wake_render_thread();
+}
+
+void MPVPlayer::process_pooled() {
+    // This method runs on the main thread, the pool calls it while the player is outside the tree
+    int init_state = async_init_state.load(std::memory_order_acquire);
+    if (init_state == ASYNC_INIT_PENDING) {
+        return;
+    }
+    if (init_state != ASYNC_INIT_IDLE) {
+        // The pool checks is_initialized() itself, nobody is connected to initialized yet
+        async_init_state.store(ASYNC_INIT_IDLE);
+        if (init_state != ASYNC_INIT_SUCCEEDED) {
+            stop_render_thread();
+        }
+    }
+
+    // Prewarm frames are never shown, but mpv still needs their swaps to keep going
+    take_frame();
+    count_presented_frame();
+
+    std::lock_guard<std::mutex> lock(event_mutex);
+    event_queue.clear();
+}
+
+bool MPVPlayer::is_idle_active() const {
+    return idle_active.load();
+}
+
+void MPVPlayer::on_mpv_wakeup(void* ctx) {
+    // Called by mpv from arbitrary threads, only flags the event thread
+    MPVPlayer* instance = static_cast<MPVPlayer*>(ctx);
+    if (instance) {
+        {
+            std::lock_guard<std::mutex> lock(instance->event_mutex);
+            instance->events_pending.store(true);
         }
+        instance->event_cv.notify_one();
     }
 }
 
-void MPVPlayer::load_file(const String& path) {
+void MPVPlayer::start_event_thread() {
+    if (!mpv || event_running.load()) {
+        return;
+    }
+
+    // Events queued before the callback was installed are drained on the first pass
+    events_pending.store(true);
+    event_running.store(true);
+    event_thread = std::thread(&MPVPlayer::event_loop, this);
+    mpv_set_wakeup_callback(mpv, on_mpv_wakeup, this);
+}
+
+void MPVPlayer::stop_event_thread() {
+    if (mpv) {
+        mpv_set_wakeup_callback(mpv, nullptr, nullptr);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(event_mutex);
+        event_running.store(false);
+    }
+    event_cv.notify_one();
+
+    if (event_thread.joinable()) {
+        event_thread.join();
+    }
+}
+
+void MPVPlayer::event_loop() {
+    std::vector<PlayerEvent> decoded;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(event_mutex);
+            event_cv.wait(lock, [this] { return !event_running.load() || events_pending.load(); });
+            if (!event_running.load()) {
+                break;
+            }
+            events_pending.store(false);
+        }
+
+        // Drain everything mpv has queued, decoding outside the lock
+        mpv_event* event = mpv_wait_event(mpv, 0);
+        while (event->event_id != MPV_EVENT_NONE) {
+            handle_mpv_event(event, decoded);
+            event = mpv_wait_event(mpv, 0);
+        }
+
+        // Publish the state once per batch, before the signals for it are queued
+        if (event_state_changed) {
+            publish_state(event_state);
+            event_state_changed = false;
+        }
+
+        if (!decoded.empty()) {
+            std::lock_guard<std::mutex> lock(event_mutex);
+            event_queue.insert(event_queue.end(), decoded.begin(), decoded.end());
+            decoded.clear();
+        }
+    }
+}
+
+void MPVPlayer::handle_mpv_event(mpv_event* event, std::vector<PlayerEvent>& out) {
+    // This method runs on the event thread, no Godot objects are touched here
+    switch (event->event_id) {
+        case MPV_EVENT_FILE_LOADED:
+            if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
+                UtilityFunctions::print("File loaded successfully");
+
+            {
+                // Playlist items load without going through load_file, mpv knows which file it is
+                PlayerEvent loaded{PlayerEvent::FILE_LOADED};
+                char* loaded_path = mpv_get_property_string(mpv, "path");
+                if (loaded_path) {
+                    loaded.text = String::utf8(loaded_path);
+                    mpv_free(loaded_path);
+                }
+                out.push_back(loaded);
+            }
+            break;
+            
+        case MPV_EVENT_PLAYBACK_RESTART:
+            if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
+                UtilityFunctions::print("Playback restarted");
+
+            // A seek is done once playback restarts at its target
+            if (seek_in_flight.exchange(false)) {
+                double pos = 0.0;
+                mpv_get_property(mpv, "time-pos", MPV_FORMAT_DOUBLE, &pos);
+                out.push_back({PlayerEvent::SEEK_COMPLETED, pos});
+            }
+            break;
+
+        case MPV_EVENT_VIDEO_RECONFIG: {
+            // The display size (after aspect correction) changed, size the render targets to match.
+            // Querying here only blocks the event thread.
+            int64_t dw = 0;
+            int64_t dh = 0;
+            if (mpv_get_property(mpv, "video-params/dw", MPV_FORMAT_INT64, &dw) < 0 ||
+                mpv_get_property(mpv, "video-params/dh", MPV_FORMAT_INT64, &dh) < 0 || dw <= 0 || dh <= 0) {
+                break;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(render_size_mutex);
+                video_width = (int)dw;
+                video_height = (int)dh;
+            }
+            update_render_size();
+            break;
+        }
+
+            
+        case MPV_EVENT_COMMAND_REPLY: {
+            if (event->reply_userdata == REPLY_SEEK) {
+                // A rejected seek (nothing loaded, unseekable stream) never restarts playback
+                if (event->error < 0) {
+                    seek_in_flight.store(false);
+                }
+                break;
+            }
+            if (!(event->reply_userdata & REPLY_LOAD_FILE)) break;
+            int64_t request_id = (int64_t)(event->reply_userdata & ~REPLY_LOAD_FILE);
+
+            if (event->error < 0) {
+                PlayerEvent failed{PlayerEvent::LOAD_FAILED};
+                failed.text = String(mpv_error_string(event->error));
+                failed.request_id = request_id;
+                out.push_back(failed);
+                break;
+            }
+
+            // Remember which playlist entry this request created, so a failure while opening it
+            // (reported by END_FILE) can be traced back to the request
+            mpv_event_command* reply = static_cast<mpv_event_command*>(event->data);
+            if (reply && reply->result.format == MPV_FORMAT_NODE_MAP) {
+                mpv_node_list* result = reply->result.u.list;
+                for (int i = 0; i < result->num; i++) {
+                    if (strcmp(result->keys[i], "playlist_entry_id") == 0 && result->values[i].format == MPV_FORMAT_INT64) {
+                        load_requests_by_entry[result->values[i].u.int64] = request_id;
+                    }
+                }
+            }
+
+            PlayerEvent started{PlayerEvent::LOAD_STARTED};
+            started.request_id = request_id;
+            out.push_back(started);
+            break;
+        }
+
+        case MPV_EVENT_END_FILE:
+            {
+                mpv_event_end_file* end_file = static_cast<mpv_event_end_file*>(event->data);
+
+                // A seek still running on the file that ended won't complete
+                seek_in_flight.store(false);
+
+                auto request = load_requests_by_entry.find(end_file->playlist_entry_id);
+                if (request != load_requests_by_entry.end()) {
+                    if (end_file->reason == MPV_END_FILE_REASON_ERROR) {
+                        PlayerEvent failed{PlayerEvent::LOAD_FAILED};
+                        failed.text = String(mpv_error_string(end_file->error));
+                        failed.request_id = request->second;
+                        out.push_back(failed);
+                    }
+                    load_requests_by_entry.erase(request);
+                }
+                
+                // Always log errors
+                if (end_file->reason == MPV_END_FILE_REASON_ERROR) {
+                    UtilityFunctions::print("ERROR: Playback failed with error code: ", end_file->error);
+                    
+                    // Get the error string
+                    const char* err_str = mpv_error_string(end_file->error);
+                    if (err_str) {
+                        UtilityFunctions::print("MPV Error: ", err_str);
+                    }
+                    
+                    // For streaming, try to provide more specific error information
+                    if (is_streaming) {
+                        UtilityFunctions::print("HTTP stream playback failed. Possible causes:");
+                        UtilityFunctions::print("- Network connectivity issues");
+                        UtilityFunctions::print("- Unsupported codec or format");
+                        UtilityFunctions::print("- Invalid URL or stream");
+                        
+                        // Try to get more diagnostic information
+                        char* media_title = nullptr;
+                        if (mpv_get_property(mpv, "media-title", MPV_FORMAT_STRING, &media_title) >= 0 && media_title) {
+                            UtilityFunctions::print("Media title: ", media_title);
+                            mpv_free(media_title);
+                        }
+                    }
+                } else if (debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL) {
+                    // Log normal end-of-file events only if debug is enabled
+                    UtilityFunctions::print("Playback ended with reason: ", end_file->reason);
+                }
+            }
+            break;
+            
+        case MPV_EVENT_LOG_MESSAGE:
+            if(debug_level == DEBUG_FULL) {
+                mpv_event_log_message* msg = static_cast<mpv_event_log_message*>(event->data);
+                UtilityFunctions::print("MPV Log [", msg->prefix, "]: ", msg->text);
+            }
+            break;
+            
+        case MPV_EVENT_PROPERTY_CHANGE: {
+            mpv_event_property *prop = static_cast<mpv_event_property *>(event->data);
+            if (!prop) break;
+
+            // Unavailable properties (no file loaded) arrive as MPV_FORMAT_NONE and read as 0
+            bool has_double = prop->format == MPV_FORMAT_DOUBLE && prop->data;
+            double double_value = has_double ? *static_cast<double *>(prop->data) : 0.0;
+
+            switch (event->reply_userdata)
+            {
+            case OBSERVE_TIME_POS:
+                event_state.time_pos = double_value;
+                event_state_changed = true;
+                if (has_double) {
+                    out.push_back({PlayerEvent::TIME_POS, double_value});
+                }
+                break;
+            case OBSERVE_DURATION:
+                event_state.duration = double_value;
+                event_state_changed = true;
+                break;
+            case OBSERVE_PERCENT_POS:
+                event_state.percent_pos = double_value;
+                event_state_changed = true;
+                break;
+            case OBSERVE_VOLUME:
+                if (has_double) {
+                    event_state.volume = double_value;
+                    event_state_changed = true;
+                }
+                break;
+            case OBSERVE_SPEED:
+                if (has_double) {
+                    event_state.speed = double_value;
+                    event_state_changed = true;
+                }
+                break;
+            case OBSERVE_SUB_DELAY:
+                if (has_double) {
+                    event_state.sub_delay = double_value;
+                    event_state_changed = true;
+                }
+                break;
+            case OBSERVE_PAUSE:
+                if (prop->format == MPV_FORMAT_FLAG && prop->data) {
+                    event_state.paused = *static_cast<int *>(prop->data) != 0;
+                    event_state_changed = true;
+                }
+                break;
+            case OBSERVE_PLAYLIST_POS: {
+                int64_t index = prop->format == MPV_FORMAT_INT64 && prop->data ? *static_cast<int64_t *>(prop->data) : -1;
+                event_state.playlist_pos = index;
+                event_state_changed = true;
+                out.push_back({PlayerEvent::PLAYLIST_POS, (double)index});
+                break;
+            }
+            case OBSERVE_PLAYLIST_COUNT:
+                event_state.playlist_count = prop->format == MPV_FORMAT_INT64 && prop->data ? *static_cast<int64_t *>(prop->data) : 0;
+                event_state_changed = true;
+                break;
+            case OBSERVE_IDLE_ACTIVE:
+                idle_active.store(prop->format == MPV_FORMAT_FLAG && prop->data && *static_cast<int *>(prop->data) != 0);
+                break;
+            case OBSERVE_TRACK_LIST:
+                if (prop->format == MPV_FORMAT_NODE && prop->data) {
+                    parse_track_list(static_cast<mpv_node *>(prop->data));
+                } else {
+                    mpv_node empty = {};
+                    parse_track_list(&empty);
+                }
+                break;
+            case OBSERVE_PAUSED_FOR_CACHE:
+            case OBSERVE_CORE_IDLE: {
+                // Both properties drive the same buffering state, only its edges are queued
+                if (prop->format != MPV_FORMAT_FLAG || !prop->data) break;
+                bool stalled = *static_cast<int *>(prop->data) != 0;
+                if (stalled != event_buffering_state) {
+                    event_buffering_state = stalled;
+                    event_state.buffering = stalled;
+                    event_state_changed = true;
+                    out.push_back({PlayerEvent::BUFFERING, stalled ? 1.0 : 0.0});
+                }
+                break;
+            }
+            case OBSERVE_SUB_TEXT: {
+                PlayerEvent sub_event{PlayerEvent::SUBTITLE};
+                if (prop->format == MPV_FORMAT_STRING && prop->data) {
+                    char* sub_text = *static_cast<char**>(prop->data);
+                    if (sub_text != nullptr) {
+                        sub_event.text = String::utf8(sub_text);
+                    }
+                }
+                // No subtitle or subtitle cleared leaves the text empty
+                out.push_back(sub_event);
+                break;
+            }
+            }
+            break;
+        }
+    }
+}
+
+void MPVPlayer::drain_events() {
+    // This method runs on the main thread
+    {
+        std::lock_guard<std::mutex> lock(event_mutex);
+        if (event_queue.empty()) {
+            return;
+        }
+        drained_events.swap(event_queue);
+    }
+
+    // Coalesce: only the latest time-pos, buffering state and subtitle survive the batch
+    bool has_time_pos = false;
+    double time_pos = 0.0;
+    bool has_buffering = false;
+    bool buffering = is_buffering;
+    bool has_subtitle = false;
+    String subtitle_text;
+    int64_t playlist_pos = last_playlist_pos;
+    bool has_seek_completed = false;
+    double seek_pos = 0.0;
+
+    for (const PlayerEvent& event : drained_events) {
+        switch (event.type) {
+            case PlayerEvent::FILE_LOADED:
+                // Reset frame counter and content flag when a new file is loaded
+                frame_count = 0;
+                had_visible_content = false;
+
+                update_keyframe_index(event.text);
+                emit_signal("loading_finished");
+                break;
+            case PlayerEvent::TIME_POS:
+                has_time_pos = true;
+                time_pos = event.value;
+                break;
+            case PlayerEvent::BUFFERING:
+                has_buffering = true;
+                buffering = event.value != 0.0;
+                break;
+            case PlayerEvent::SUBTITLE:
+                has_subtitle = true;
+                subtitle_text = event.text;
+                break;
+            case PlayerEvent::LOAD_STARTED:
+                emit_signal("load_started", event.request_id);
+                break;
+            case PlayerEvent::LOAD_FAILED:
+                emit_signal("load_failed", event.request_id, event.text);
+                break;
+            case PlayerEvent::PLAYLIST_POS:
+                playlist_pos = (int64_t)event.value;
+                break;
+            case PlayerEvent::SEEK_COMPLETED:
+                has_seek_completed = true;
+                seek_pos = event.value;
+                break;
+        }
+    }
+    drained_events.clear();
+
+    if (has_time_pos) {
+        emit_signal("time_changed", time_pos);
+    }
+
+    if (has_buffering && buffering != is_buffering) {
+        is_buffering = buffering;
+        emit_signal(buffering ? "buffering_started" : "buffering_ended");
+    }
+
+    // Only emit if text changed to avoid spam
+    if (has_subtitle && subtitle_text != last_subtitle_text) {
+        last_subtitle_text = subtitle_text;
+        emit_signal("subtitle_changed", subtitle_text);
+    }
+
+    if (playlist_pos != last_playlist_pos) {
+        last_playlist_pos = playlist_pos;
+        emit_signal("playlist_item_changed", playlist_pos);
+    }
+
+    // Intermediate seeks a newer target superseded are not reported, nor the frame cache's own
+    if (has_seek_completed && !seek_pending && jog_state == JOG_IDLE) {
+        emit_signal("seek_completed", seek_pos);
+    }
+}
+
+// Per-file options passed with loadfile, so loading one file never changes the defaults for the next
+static const char* const STREAM_LOAD_OPTIONS[][2] = {
+    {"network-timeout", "60"}, // 60 seconds timeout (default in mpv)
+    {"demuxer-readahead-secs", "20"}, // Read ahead 20 seconds
+    {"cache", "yes"}, // Enable cache
+    {"cache-secs", "15"},
+    {"force-seekable", "yes"}, // Try to make stream seekable
+    {"hr-seek", "yes"},
+    {"hr-seek-demuxer-offset", "1.5"},
+    {"stream-buffer-size", "10M"}
+};
+
+static const char* const FILE_LOAD_OPTIONS[][2] = {
+    {"cache", "auto"}
+};
+
+static mpv_node make_string_node(const char* value) {
+    mpv_node node;
+    node.format = MPV_FORMAT_STRING;
+    node.u.string = const_cast<char*>(value);
+    return node;
+}
+
+int64_t MPVPlayer::load_file(const String& path) {
     UtilityFunctions::print("Loading video: ", path);
     
     // Check if MPV is initialized
-    if (!mpv) {
+    if (!is_initialized()) {
         UtilityFunctions::print("MPV is not initialized");
+        return -1;
+    }
+    
+    // Check if this is a streaming URL
+    is_streaming = path.begins_with("http://") || path.begins_with("https://");
+    
+    // Reset frame counter and content flag when loading a new file/stream
+    frame_count = 0;
+    had_visible_content = false;
+
+    // Targets and cached frames meant for the previous file
+    seek_pending = false;
+    has_scrub_target = false;
+    reset_jog();
+
+    // Convert Godot String to C string - we need to keep the CharString alive
+    // until after the command is executed to prevent the pointer from becoming invalid
+    CharString cs = path.utf8();
+    const char* c_path = cs.get_data();
+    
+    if (c_path == nullptr || c_path[0] == '\0') {
+        UtilityFunctions::print("ERROR: Invalid empty path");
+        return -1;
+    }
+    
+    UtilityFunctions::print("Loading path: '", c_path, "'");
+
+    if (is_streaming) {
+        UtilityFunctions::print("Detected HTTP stream, enabling streaming mode");
+    }
+
+    return send_loadfile(path, "replace");
+}
+
+int64_t MPVPlayer::send_loadfile(const String& path, const char* flags, int64_t index) {
+    CharString cs = path.utf8();
+    const char* c_path = cs.get_data();
+    bool streaming = path.begins_with("http://") || path.begins_with("https://");
+
+    // Per-file options map
+    const char* const (*load_options)[2] = streaming ? STREAM_LOAD_OPTIONS : FILE_LOAD_OPTIONS;
+    int option_count = streaming ? (int)(sizeof(STREAM_LOAD_OPTIONS) / sizeof(STREAM_LOAD_OPTIONS[0]))
+                                 : (int)(sizeof(FILE_LOAD_OPTIONS) / sizeof(FILE_LOAD_OPTIONS[0]));
+    std::vector<char*> option_keys(option_count);
+    std::vector<mpv_node> option_values(option_count);
+    for (int i = 0; i < option_count; i++) {
+        option_keys[i] = const_cast<char*>(load_options[i][0]);
+        option_values[i] = make_string_node(load_options[i][1]);
+    }
+    mpv_node_list option_list = {option_count, option_values.data(), option_keys.data()};
+
+    mpv_node options;
+    options.format = MPV_FORMAT_NODE_MAP;
+    options.u.list = &option_list;
+
+    // loadfile with named arguments, mpv copies the whole node before returning
+    mpv_node index_node;
+    index_node.format = MPV_FORMAT_INT64;
+    index_node.u.int64 = index;
+
+    char* arg_keys[] = {const_cast<char*>("name"), const_cast<char*>("url"), const_cast<char*>("flags"), const_cast<char*>("options"), const_cast<char*>("index")};
+    mpv_node arg_values[] = {make_string_node("loadfile"), make_string_node(c_path), make_string_node(flags), options, index_node};
+    mpv_node_list arg_list = {index >= 0 ? 5 : 4, arg_values, arg_keys};
+
+    mpv_node args;
+    args.format = MPV_FORMAT_NODE_MAP;
+    args.u.list = &arg_list;
+
+    // Never blocks: slow DNS or TLS handshakes are reported back through load_started/load_failed
+    int64_t request_id = ++next_load_request_id;
+    int result = mpv_command_node_async(mpv, REPLY_LOAD_FILE | (uint64_t)request_id, &args);
+    if (result < 0) {
+        UtilityFunctions::print("Error loading file: ", mpv_error_string(result));
+
+        // Reported from drain_events like mpv's own failures, after the caller has the request id
+        PlayerEvent failed{PlayerEvent::LOAD_FAILED};
+        failed.text = String(mpv_error_string(result));
+        failed.request_id = request_id;
+        std::lock_guard<std::mutex> lock(event_mutex);
+        event_queue.push_back(failed);
+    }
+    return request_id;
+}
+
+int64_t MPVPlayer::playlist_append(const String& path) {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return -1;
+    }
+    if (path.is_empty()) {
+        ERR_PRINT("Invalid empty path");
+        return -1;
+    }
+    return send_loadfile(path, "append-play");
+}
+
+int64_t MPVPlayer::playlist_insert(int index, const String& path) {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return -1;
+    }
+    if (path.is_empty()) {
+        ERR_PRINT("Invalid empty path");
+        return -1;
+    }
+
+    // Negative appends. Any other index goes to mpv as is, the playlist_count snapshot lags behind
+    // appends still in flight, and mpv appends an index past the end. The named index argument
+    // needs mpv 0.38.
+    if (index < 0) {
+        return send_loadfile(path, "append-play");
+    }
+    return send_loadfile(path, "insert-at-play", index);
+}
+
+void MPVPlayer::playlist_remove(int index) {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    std::string index_arg = std::to_string(index);
+    const char* cmd[] = {"playlist-remove", index_arg.c_str(), nullptr};
+    mpv_command_async(mpv, 0, cmd);
+}
+
+void MPVPlayer::playlist_move(int from, int to) {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    if (from == to) {
+        return;
+    }
+
+    // mpv inserts before the entry at the target index, which lands one short when moving forward
+    std::string from_arg = std::to_string(from);
+    std::string to_arg = std::to_string(to > from ? to + 1 : to);
+    const char* cmd[] = {"playlist-move", from_arg.c_str(), to_arg.c_str(), nullptr};
+    mpv_command_async(mpv, 0, cmd);
+}
+
+void MPVPlayer::playlist_clear() {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    const char* cmd[] = {"playlist-clear", nullptr};
+    mpv_command_async(mpv, 0, cmd);
+}
+
+void MPVPlayer::playlist_next() {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    const char* cmd[] = {"playlist-next", nullptr};
+    mpv_command_async(mpv, 0, cmd);
+}
+
+void MPVPlayer::playlist_prev() {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    const char* cmd[] = {"playlist-prev", nullptr};
+    mpv_command_async(mpv, 0, cmd);
+}
+
+void MPVPlayer::set_playlist_index(int index) {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    queue_property_int(QUEUED_PLAYLIST_POS, index);
+}
+
+int MPVPlayer::get_playlist_index() const {
+    return (int)read_state().playlist_pos;
+}
+
+int MPVPlayer::get_playlist_count() const {
+    return (int)read_state().playlist_count;
+}
+
+void MPVPlayer::set_playlist_loop(bool enabled) {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    queue_property_int(QUEUED_LOOP_PLAYLIST, enabled ? 1 : 0);
+}
+
+void MPVPlayer::play() {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
+    UtilityFunctions::print("Starting playback");
+
+    // Continue from the cached frame on screen rather than from wherever the frame cache left mpv
+    if (jog_cursor >= 0) {
+        bool elsewhere = jog_cursor != jog_live || jog_state != JOG_IDLE;
+        double pts = frame_cache.get(jog_cursor).pts;
+        reset_jog();
+        if (elsewhere) {
+            schedule_seek(pts, SEEK_ABSOLUTE);
+        }
+    }
+    
+    queue_property_int(QUEUED_PAUSE, 0);
+}
+
+void MPVPlayer::set_volume(double value) {
+    if (!is_initialized()) {
+        //ERR_PRINT("MPV not initialized");
+        return;
+    }
+    queue_property_double(QUEUED_VOLUME, value);
+}
+
+double MPVPlayer::get_volume() const {
+    return read_state().volume;
+}
+
+void MPVPlayer::set_aspect_ratio(String ratio) {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+
+    // Accepts "16:9", "1.85" or "-1" (use the video's own aspect), parsed once here instead of by mpv
+    double aspect = -1.0;
+    int separator = ratio.find(":");
+    if (separator >= 0) {
+        double denominator = ratio.substr(separator + 1).to_float();
+        if (denominator > 0.0) {
+            aspect = ratio.substr(0, separator).to_float() / denominator;
+        }
+    } else if (ratio.is_valid_float()) {
+        aspect = ratio.to_float();
+    }
+    queue_property_double(QUEUED_ASPECT, aspect);
+}
+
+void MPVPlayer::set_playback_speed(double speed) {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    queue_property_double(QUEUED_SPEED, speed);
+}
+
+void MPVPlayer::set_repeat_file(String value) {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queued_string_mutex);
+        queued_loop_file = value;
+    }
+    queue_property_int(QUEUED_LOOP_FILE, 0);
+}
+
+void MPVPlayer::restart() {
+        if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    const char* cmd[] = {"seek", "0", "absolute", nullptr};
+    mpv_command_async(mpv, 0, cmd);
+}
+
+void MPVPlayer::set_audio_track(int id) {
+        if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    queue_property_int(QUEUED_AID, id);
+}
+
+void MPVPlayer::set_subtitle_track(int id) {
+        if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    queue_property_int(QUEUED_SID, id);
+}
+
+void MPVPlayer::add_subtitle_file(String path, String title, String lang) {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+
+    CharString cs = path.utf8();
+    const char* c_path = cs.get_data();
+
+    if (c_path == nullptr || c_path[0] == '\0') {
+        UtilityFunctions::print("ERROR: Invalid empty subtitle path");
+        return;
+    }
+
+    if (debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
+        UtilityFunctions::print("Adding external subtitle file: ", path);
+
+
+    CharString title_cs = title.utf8();
+    CharString lang_cs = lang.utf8();
+    const char* cmd[] = { "sub-add", c_path, "auto", title_cs.get_data(), lang_cs.get_data(), nullptr };
+    mpv_command_async(mpv, 0, cmd);
+    //int result = mpv_command(mpv, cmd);
+
+    //if (result < 0) {
+    //    UtilityFunctions::print("Error loading subtitle file: ", mpv_error_string(result));
+    //}
+    //else {
+    //    if (debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
+    //        UtilityFunctions::print("Subtitle file loaded successfully");
+    //}
+}
+
+
+double MPVPlayer::get_content_aspect_ratio() {
+    int width;
+    int height;
+    double aspect;
+
+    mpv_get_property(mpv, "video-params/w", MPV_FORMAT_INT64, &width);
+    mpv_get_property(mpv, "video-params/h", MPV_FORMAT_INT64, &height);
+
+    return aspect = (double)width / (double)height;
+}
+
+void MPVPlayer::seek_content_pos(String pos) {
+        if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    schedule_seek(pos.to_float(), SEEK_ABSOLUTE);
+}
+
+
+void MPVPlayer::seek(String seconds, bool relative) {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    schedule_seek(seconds.to_float(), relative ? SEEK_RELATIVE : SEEK_ABSOLUTE);
+}
+
+void MPVPlayer::seek_to_percentage(String pos) {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    schedule_seek(pos.to_float(), SEEK_PERCENT);
+}
+
+void MPVPlayer::set_scrubbing(bool enabled) {
+    if (enabled == scrubbing) {
+        return;
+    }
+    scrubbing = enabled;
+
+    if (!enabled && has_scrub_target) {
+        // One exact seek to where the drag stopped, replacing any keyframe seek still waiting
+        has_scrub_target = false;
+        pending_seek = scrub_target;
+        pending_seek.precision = SEEK_PRECISION_EXACT;
+        seek_pending = true;
+    }
+}
+
+bool MPVPlayer::is_scrubbing() const {
+    return scrubbing;
+}
+
+double MPVPlayer::get_seek_destination() const {
+    // Where playback is headed once the scheduled seeks are done, in seconds
+    const SeekRequest* request = seek_pending ? &pending_seek : (has_scrub_target ? &scrub_target : nullptr);
+    if (!request || request->mode == SEEK_RELATIVE) {
+        return get_time_pos() + (request ? request->target : 0.0);
+    }
+    if (request->mode == SEEK_PERCENT) {
+        return request->target * get_duration() / 100.0;
+    }
+    return request->target;
+}
+
+void MPVPlayer::schedule_seek(double target, SeekMode mode) {
+    // This method runs on the main thread
+    if (jog_cursor >= 0) {
+        // Relative seeks start from the cached frame on screen
+        if (mode == SEEK_RELATIVE && !seek_pending) {
+            target += get_time_pos();
+            mode = SEEK_ABSOLUTE;
+        }
+        reset_jog();
+    }
+
+    if (mode == SEEK_RELATIVE) {
+        if (seek_pending && pending_seek.mode == SEEK_RELATIVE) {
+            target += pending_seek.target;
+        } else if (seek_pending || scrubbing) {
+            // Relative to where the newest request is heading, not to wherever playback is right now
+            target += get_seek_destination();
+            mode = SEEK_ABSOLUTE;
+        }
+    }
+
+    pending_seek.target = target;
+    pending_seek.mode = mode;
+    pending_seek.precision = scrubbing ? SEEK_PRECISION_KEYFRAMES : SEEK_PRECISION_DEFAULT;
+    seek_pending = true;
+
+    if (scrubbing) {
+        scrub_target = pending_seek;
+        has_scrub_target = true;
+    }
+}
+
+void MPVPlayer::flush_pending_seek() {
+    // This method runs on the main thread
+    if (!seek_pending || !mpv || seek_in_flight.load()) {
+        return;
+    }
+    seek_pending = false;
+
+    SeekRequest request = pending_seek;
+    const KeyframeIndex* index = get_ready_keyframe_index();
+    if (index && request.mode != SEEK_RELATIVE) {
+        plan_keyframe_seek(request, *index);
+    }
+
+    static const char* const MODE_FLAGS[] = {"absolute", "relative", "absolute-percent"};
+    static const char* const PRECISION_FLAGS[] = {"", "+keyframes", "+exact"};
+    String flags = String(MODE_FLAGS[request.mode]) + PRECISION_FLAGS[request.precision];
+
+    CharString target = String::num(request.target, 6).utf8();
+    CharString flag_data = flags.utf8();
+    const char* cmd[] = {"seek", target.get_data(), flag_data.get_data(), nullptr};
+
+    seek_in_flight.store(true);
+    if (mpv_command_async(mpv, REPLY_SEEK, cmd) < 0) {
+        seek_in_flight.store(false);
+    }
+}
+
+void MPVPlayer::plan_keyframe_seek(SeekRequest& request, const KeyframeIndex& index) const {
+    double duration = get_duration();
+    if (request.mode == SEEK_PERCENT && duration <= 0.0) {
+        return;
+    }
+    double target = request.mode == SEEK_PERCENT ? request.target * duration / 100.0 : request.target;
+
+    double keyframe = index.get_nearest(target);
+    if (keyframe < 0.0) {
+        return;
+    }
+
+    // Exact seeks further from a keyframe still decode from the one before, nothing to gain
+    if (request.precision != SEEK_PRECISION_KEYFRAMES && std::abs(target - keyframe) > KEYFRAME_SNAP_TOLERANCE) {
         return;
     }
-    
-    // Check if this is a streaming URL
-    is_streaming = path.begins_with("http://") || path.begins_with("https://");
-    
-    // Reset frame counter and content flag when loading a new file/stream
-    frame_count = 0;
-    had_visible_content = false;
-    
-    if (is_streaming) {
-        UtilityFunctions::print("Detected HTTP stream, enabling streaming mode");
-     
-
-        mpv_set_option_string(mpv, "network-timeout", "60"); // 60 seconds timeout (default in mpv)
-        mpv_set_option_string(mpv, "demuxer-readahead-secs", "20"); // Read ahead 20 seconds
-        mpv_set_option_string(mpv, "cache", "yes"); // Enable cache
-        mpv_set_option_string(mpv, "cache-secs", "15"); // Cache 30 seconds (more generous)
-        mpv_set_option_string(mpv, "force-seekable", "yes"); // Try to make stream seekable
-        mpv_set_option_string(mpv, "hr-seek", "yes");
-        mpv_set_option_string(mpv, "hr-seek-demuxer-offset", "1.5");
-        mpv_set_option_string(mpv, "stream-buffer-size", "10M");
-        
-        // Set these to match command-line behavior
-        // mpv_set_option_string(mpv, "audio-file-auto", "no"); // Don't load external audio
-        // mpv_set_option_string(mpv, "sub-auto", "no"); // Don't load subtitles
 
-        // mpv_set_option_string(mpv, "stream-lavf-o", headers.utf8().get_data());
-        
-        UtilityFunctions::print("Applied streaming-specific MPV options");
-    } else {
-        // Local file options
-        mpv_set_option_string(mpv, "cache", "auto");
+    // A keyframe seek lands on the last keyframe at or before its target. Aiming halfway to the
+    // next one makes it land on this keyframe even if the container's timestamps are off by a frame.
+    double next = index.get_after(keyframe);
+    request.target = keyframe + (next > keyframe ? std::min((next - keyframe) / 2.0, 0.5) : 0.5);
+    request.mode = SEEK_ABSOLUTE;
+    request.precision = SEEK_PRECISION_KEYFRAMES;
+}
+
+void MPVPlayer::update_keyframe_index(const String& path) {
+    // This method runs on the main thread
+    String local_path = path.begins_with("file://") ? path.substr(7) : path;
+    bool local = local_path.find("://") < 0 || local_path.begins_with("res://") || local_path.begins_with("user://");
+
+    if (!keyframe_index_enabled || !local || local_path.is_empty()) {
+        keyframe_index.reset();
+        return;
     }
-    
-    // Convert Godot String to C string - we need to keep the CharString alive
-    // until after the command is executed to prevent the pointer from becoming invalid
-    CharString cs = path.utf8();
-    const char* c_path = cs.get_data();
-    
-    if (c_path == nullptr || c_path[0] == '\0') {
-        UtilityFunctions::print("ERROR: Invalid empty path");
+    if (keyframe_index && keyframe_index->get_path() == local_path) {
         return;
     }
-    
-    UtilityFunctions::print("Loading path: '", c_path, "'");
-    
-    // For HTTP streams, use synchronous command to match command-line behavior
-    // This ensures the command completes before continuing
-    if (is_streaming) {
-        const char* cmd[] = {"loadfile", c_path, nullptr};
-        int result = mpv_command(mpv, cmd);
-        if (result < 0) {
-            UtilityFunctions::print("Error loading stream: ", mpv_error_string(result));
-        } else {
-            UtilityFunctions::print("Stream loaded successfully");
-        }
-    } else {
-        // For local files, use async command as before
-        const char* cmd[] = {"loadfile", c_path, nullptr};
-        mpv_command_async(mpv, 0, cmd);
+
+    // Replacing the index cancels a build still running for the previous file
+    keyframe_index = std::make_unique<KeyframeIndex>(local_path);
+    keyframe_index_reported = false;
+}
+
+const KeyframeIndex* MPVPlayer::get_ready_keyframe_index() const {
+    if (!keyframe_index || !keyframe_index->is_ready() || keyframe_index->get_times().empty()) {
+        return nullptr;
     }
+    return keyframe_index.get();
 }
 
-void MPVPlayer::play() {
-    if (!mpv) {
-        ERR_PRINT("MPV not initialized");
-        return;
+void MPVPlayer::set_keyframe_index_enabled(bool enabled) {
+    keyframe_index_enabled = enabled;
+    if (!enabled) {
+        keyframe_index.reset();
     }
-    if(debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
-    UtilityFunctions::print("Starting playback");
-    
-    const char* cmd[] = {"set", "pause", "no", nullptr};
-    mpv_command_async(mpv, 0, cmd);
 }
 
-void MPVPlayer::set_volume(String value) {
-    if (!mpv) {
-        //ERR_PRINT("MPV not initialized");
-        return;
+bool MPVPlayer::get_keyframe_index_enabled() const {
+    return keyframe_index_enabled;
+}
+
+bool MPVPlayer::is_keyframe_index_ready() const {
+    return get_ready_keyframe_index() != nullptr;
+}
+
+PackedFloat64Array MPVPlayer::get_keyframes() const {
+    PackedFloat64Array result;
+    const KeyframeIndex* index = get_ready_keyframe_index();
+    if (index) {
+        const std::vector<double>& times = index->get_times();
+        result.resize((int64_t)times.size());
+        memcpy(result.ptrw(), times.data(), times.size() * sizeof(double));
     }
-    const char* cmd[] = {"set", "volume", value.utf8().get_data(), nullptr};
-    mpv_command_async(mpv, 0, cmd);
+    return result;
 }
 
-double MPVPlayer::get_volume() const {
-    return get_property_double("volume", 100.0);
+double MPVPlayer::get_nearest_keyframe(double time) const {
+    const KeyframeIndex* index = get_ready_keyframe_index();
+    return index ? index->get_nearest(time) : -1.0;
 }
 
-void MPVPlayer::set_aspect_ratio(String ratio) {
-    if (!mpv) {
-        ERR_PRINT("MPV not initialized");
-        return;
+// ==================== Jog/Shuttle ====================
+
+// A copy of the frame on screen for the frame cache. The pixels are shared copy-on-write, the
+// render thread makes its own copy if it ever writes to that slot again.
+static Ref<Image> copy_frame(const Ref<Image>& frame) {
+    return Image::create_from_data(frame->get_width(), frame->get_height(), false, Image::FORMAT_RGBA8, frame->get_data());
+}
+
+void MPVPlayer::reset_jog() {
+    // This method runs on the main thread
+    frame_cache.clear();
+    jog_state = JOG_IDLE;
+    jog_cursor = -1;
+    jog_live = -1;
+    jog_pending_steps = 0;
+    jog_refill_frames.clear();
+    reverse_playback = false;
+    reverse_elapsed = 0.0;
+    shown_frame_pts.store(-1.0);
+}
+
+bool MPVPlayer::seed_jog() {
+    // The frame on screen becomes the first cached one
+    const Ref<Image>& frame = frame_slots[front_slot];
+    if (frame_texture.is_null() || frame.is_null() || frame->get_width() <= 0) {
+        return false;
     }
-    const char* cmd[] = {"set", "video-aspect-override", ratio.utf8().get_data(), nullptr};
-    mpv_command_async(mpv, 0, cmd);
+    // A frame rendered before mpv reported any time-pos carries no pts, mpv steps on its own until one does
+    double pts = frame_slot_pts[front_slot];
+    if (pts < 0.0) {
+        return false;
+    }
+
+    queue_property_int(QUEUED_PAUSE, 1);
+    frame_cache.clear();
+    frame_cache.push_back(pts, copy_frame(frame));
+    jog_cursor = 0;
+    jog_live = 0;
+    return true;
 }
 
-void MPVPlayer::set_playback_speed(String speed) {
-    if (!mpv) {
-        ERR_PRINT("MPV not initialized");
+void MPVPlayer::step_jog(int direction) {
+    // This method runs on the main thread
+    if (jog_state != JOG_IDLE || seek_pending || seek_in_flight.load()) {
+        jog_pending_steps += direction;
+        return;
+    }
+    if (jog_cursor < 0 && !seed_jog()) {
+        // Nothing on screen yet, let mpv step on its own
+        const char* cmd[] = {direction > 0 ? "frame-step" : "frame-back-step", nullptr};
+        mpv_command_async(mpv, 0, cmd);
         return;
     }
-    const char* cmd[] = {"set", "speed", speed.utf8().get_data(), nullptr};
-    mpv_command_async(mpv, 0, cmd);
-}
 
-void MPVPlayer::set_repeat_file(String value) {
-    if (!mpv) {
-        ERR_PRINT("MPV not initialized");
+    int target = jog_cursor + direction;
+    if (target >= 0 && target < frame_cache.size()) {
+        frame_cache.record_hit();
+        show_jog_frame(target);
         return;
     }
-    const char* cmd[] = {"set", "loop-file", value.utf8().get_data(), nullptr};
-    mpv_command_async(mpv, 0, cmd);
-}
 
-void MPVPlayer::restart() {
-        if (!mpv) {
-        ERR_PRINT("MPV not initialized");
+    if (direction < 0) {
+        if (start_jog_refill()) {
+            frame_cache.record_miss();
+        } else {
+            // Already on the first frame of the file
+            reverse_playback = false;
+        }
         return;
     }
-    const char* cmd[] = {"seek", "0", "absolute", nullptr};
-    mpv_command_async(mpv, 0, cmd);
+
+    frame_cache.record_miss();
+    if (jog_live == jog_cursor) {
+        send_jog_step();
+    } else {
+        // mpv is still where a refill left it, bring it back to the frame on screen first
+        send_jog_seek(frame_cache.get(jog_cursor).pts);
+        jog_state = JOG_SYNCING;
+    }
 }
 
-void MPVPlayer::set_audio_track(String id) {
-        if (!mpv) {
-        ERR_PRINT("MPV not initialized");
+void MPVPlayer::show_jog_frame(int index) {
+    const FrameCache::Frame& frame = frame_cache.get(index);
+    jog_cursor = index;
+    shown_frame_pts.store(index == jog_live ? -1.0 : frame.pts);
+    upload_frame(frame.image);
+    emit_signal("time_changed", frame.pts);
+}
+
+void MPVPlayer::capture_jog_frame() {
+    // This method runs on the main thread, with the frame mpv just produced in the front slot.
+    // Its pts was taken by the render thread when mpv announced the frame.
+    double pts = frame_slot_pts[front_slot];
+    if (pts < 0.0 || !jog_seek_done) {
+        // Still showing whatever was there before the jog seek
         return;
     }
-    const char* cmd[] = {"set", "aid", id.utf8().get_data(), nullptr};
-    mpv_command_async(mpv, 0, cmd);
-}
+    const Ref<Image>& frame = frame_slots[front_slot];
 
-void MPVPlayer::set_subtitle_track(String id) {
-        if (!mpv) {
-        ERR_PRINT("MPV not initialized");
+    if (jog_state == JOG_REFILLING) {
+        if (pts >= jog_refill_target - FrameCache::PTS_TOLERANCE) {
+            finish_jog_refill();
+            return;
+        }
+        if (!jog_refill_frames.empty() && std::abs(pts - jog_refill_frames.back().pts) <= FrameCache::PTS_TOLERANCE) {
+            jog_refill_frames.back().image = copy_frame(frame);
+            return;
+        }
+        if (jog_refill_frames.empty() || pts > jog_refill_frames.back().pts) {
+            jog_refill_frames.push_back({pts, copy_frame(frame)});
+        }
+        const char* cmd[] = {"frame-step", nullptr};
+        mpv_command_async(mpv, 0, cmd);
+        jog_deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(JOG_TIMEOUT_USEC);
         return;
     }
-    const char* cmd[] = {"set", "sid", id.utf8().get_data(), nullptr};
-    mpv_command_async(mpv, 0, cmd);
-}
 
-void MPVPlayer::add_subtitle_file(String path, String title, String lang) {
-    if (!mpv) {
-        ERR_PRINT("MPV not initialized");
+    if (jog_state != JOG_STEPPING) {
         return;
     }
 
-    CharString cs = path.utf8();
-    const char* c_path = cs.get_data();
+    int dropped = frame_cache.push_back(pts, copy_frame(frame));
+    if (dropped < 0) {
+        return;
+    }
+    jog_cursor = jog_cursor >= dropped ? jog_cursor - dropped : -1;
 
-    if (c_path == nullptr || c_path[0] == '\0') {
-        UtilityFunctions::print("ERROR: Invalid empty subtitle path");
+    // A redraw of the frame the step started from keeps waiting for the step itself
+    if (pts > jog_step_from + FrameCache::PTS_TOLERANCE) {
+        jog_state = JOG_IDLE;
+        jog_live = frame_cache.size() - 1;
+        show_jog_frame(jog_live);
+    }
+}
+
+void MPVPlayer::update_jog(double delta) {
+    // This method runs on the main thread, after the events of this frame were drained
+    if (jog_state != JOG_IDLE) {
+        if (std::chrono::steady_clock::now() > jog_deadline) {
+            // End of the file, or mpv stopped producing frames
+            if (debug_level != DEBUG_NONE) {
+                UtilityFunctions::print("Frame step timed out");
+            }
+            if (jog_state != JOG_STEPPING) {
+                // The seek moved mpv away from the cached frames
+                jog_live = -1;
+                if (jog_cursor >= 0) {
+                    shown_frame_pts.store(frame_cache.get(jog_cursor).pts);
+                }
+            }
+            jog_state = JOG_IDLE;
+            jog_pending_steps = 0;
+            jog_refill_frames.clear();
+            reverse_playback = false;
+            return;
+        }
+
+        if (!jog_seek_done && !seek_in_flight.load()) {
+            jog_seek_done = true;
+            if (jog_state == JOG_SYNCING) {
+                jog_live = jog_cursor;
+                send_jog_step();
+            } else if (jog_state == JOG_REFILLING && jog_cursor >= 0) {
+                // The frame the seek landed on may have been published before the seek was
+                // reported, it is still in the front slot
+                capture_jog_frame();
+            }
+        }
         return;
     }
 
-    if (debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
-        UtilityFunctions::print("Adding external subtitle file: ", path);
+    if (jog_pending_steps != 0 && !seek_pending && !seek_in_flight.load()) {
+        int direction = jog_pending_steps > 0 ? 1 : -1;
+        jog_pending_steps -= direction;
+        step_jog(direction);
+        return;
+    }
 
+    if (reverse_playback) {
+        double frame_duration = frame_cache.get_frame_duration(JOG_FALLBACK_FRAME_DURATION);
+        reverse_elapsed += delta * std::max(read_state().speed, 0.01);
+        if (reverse_elapsed >= frame_duration) {
+            // Frames the refills couldn't keep up with are skipped rather than played late
+            reverse_elapsed = std::fmod(reverse_elapsed, frame_duration);
+            step_jog(-1);
+        }
+    }
+}
 
-    CharString title_cs = title.utf8();
-    CharString lang_cs = lang.utf8();
-    const char* cmd[] = { "sub-add", c_path, "auto", title_cs.get_data(), lang_cs.get_data(), nullptr };
+void MPVPlayer::send_jog_step() {
+    const char* cmd[] = {"frame-step", nullptr};
     mpv_command_async(mpv, 0, cmd);
-    //int result = mpv_command(mpv, cmd);
+    jog_step_from = frame_cache.get(frame_cache.size() - 1).pts;
+    jog_seek_done = true;
+    jog_state = JOG_STEPPING;
+    jog_deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(JOG_TIMEOUT_USEC);
+}
 
-    //if (result < 0) {
-    //    UtilityFunctions::print("Error loading subtitle file: ", mpv_error_string(result));
-    //}
-    //else {
-    //    if (debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL)
-    //        UtilityFunctions::print("Subtitle file loaded successfully");
-    //}
+void MPVPlayer::send_jog_seek(double pts) {
+    // Sent directly rather than through the seek scheduler, which would drop the cache
+    CharString target = String::num(pts, 6).utf8();
+    const char* cmd[] = {"seek", target.get_data(), "absolute+exact", nullptr};
+
+    jog_seek_done = false;
+    jog_deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(JOG_TIMEOUT_USEC);
+    seek_in_flight.store(true);
+    if (mpv_command_async(mpv, REPLY_SEEK, cmd) < 0) {
+        seek_in_flight.store(false);
+    }
 }
 
+bool MPVPlayer::start_jog_refill() {
+    const FrameCache::Frame& oldest = frame_cache.get(0);
+    if (oldest.pts <= FrameCache::PTS_TOLERANCE) {
+        return false;
+    }
 
-double MPVPlayer::get_content_aspect_ratio() {
-    int width;
-    int height;
-    double aspect;
+    // Fill half the cache with earlier frames, the other half keeps the frames just stepped
+    // through for stepping forward again
+    double frame_duration = frame_cache.get_frame_duration(JOG_FALLBACK_FRAME_DURATION);
+    int capacity = frame_cache.get_capacity(oldest.image);
+    double start = std::max(oldest.pts - std::max(capacity / 2, 1) * frame_duration, 0.0);
 
-    mpv_get_property(mpv, "video-params/w", MPV_FORMAT_INT64, &width);
-    mpv_get_property(mpv, "video-params/h", MPV_FORMAT_INT64, &height);
+    // Starting on a keyframe spares decoding up to it, worth a longer refill while it still fits
+    const KeyframeIndex* index = get_ready_keyframe_index();
+    if (index) {
+        double keyframe = index->get_before(start + KEYFRAME_SNAP_TOLERANCE);
+        if (keyframe >= 0.0 && oldest.pts - keyframe <= (capacity - 1) * frame_duration) {
+            start = keyframe;
+        }
+    }
 
-    return aspect = (double)width / (double)height;
+    jog_refill_target = oldest.pts;
+    jog_refill_frames.clear();
+    jog_refill_count++;
+    send_jog_seek(start);
+    jog_state = JOG_REFILLING;
+    return true;
 }
 
-void MPVPlayer::seek_content_pos(String pos) {
-        if (!mpv) {
-        ERR_PRINT("MPV not initialized");
+void MPVPlayer::finish_jog_refill() {
+    // mpv has reached the oldest cached frame again
+    jog_state = JOG_IDLE;
+    int added = (int)jog_refill_frames.size();
+    if (added == 0) {
+        jog_live = 0;
+        jog_cursor = 0;
+        reverse_playback = false;
         return;
     }
-    const char* seek_cmd[] = {"seek", pos.utf8().get_data(), "absolute", nullptr};
-    mpv_command(mpv, seek_cmd);
+
+    frame_cache.push_front(jog_refill_frames);
+    jog_refill_frames.clear();
+    jog_live = added < frame_cache.size() ? added : -1;
+
+    // The step back that started the refill
+    show_jog_frame(std::min(added, frame_cache.size()) - 1);
 }
 
+void MPVPlayer::frame_step() {
+    if (!is_initialized()) {
+        ERR_PRINT("MPV not initialized");
+        return;
+    }
+    reverse_playback = false;
 
-void MPVPlayer::seek(String seconds, bool relative) {
-    if (!mpv) {
+    if (!frame_cache.is_enabled()) {
+        const char* cmd[] = {"frame-step", nullptr};
+        mpv_command_async(mpv, 0, cmd);
+        return;
+    }
+    step_jog(1);
+}
+
+void MPVPlayer::frame_back_step() {
+    if (!is_initialized()) {
         ERR_PRINT("MPV not initialized");
         return;
     }
+    reverse_playback = false;
 
-    const char* seek_cmd[] = { "seek", seconds.utf8().get_data(),  relative ? "relative" : "absolute", nullptr };
-    mpv_command(mpv, seek_cmd);
+    if (!frame_cache.is_enabled()) {
+        const char* cmd[] = {"frame-back-step", nullptr};
+        mpv_command_async(mpv, 0, cmd);
+        return;
+    }
+    step_jog(-1);
 }
 
-void MPVPlayer::seek_to_percentage(String pos) {
-    if (!mpv) {
+void MPVPlayer::set_frame_cache_budget_mb(int megabytes) {
+    reset_jog();
+    frame_cache.set_budget((uint64_t)std::max(megabytes, 0) * 1024 * 1024);
+}
+
+int MPVPlayer::get_frame_cache_budget_mb() const {
+    return (int)(frame_cache.get_budget() / (1024 * 1024));
+}
+
+void MPVPlayer::set_reverse_playback(bool enabled) {
+    if (!is_initialized()) {
         ERR_PRINT("MPV not initialized");
         return;
     }
-    const char* seek_cmd[] = { "seek", pos.utf8().get_data(), "absolute-percent", nullptr };
-    mpv_command(mpv, seek_cmd);
+    if (enabled && !frame_cache.is_enabled()) {
+        ERR_PRINT("Reverse playback needs a frame cache budget");
+        return;
+    }
+
+    if (enabled && jog_cursor < 0 && !seed_jog()) {
+        return;
+    }
+    reverse_playback = enabled;
+    reverse_elapsed = 0.0;
+}
+
+bool MPVPlayer::is_reverse_playback() const {
+    return reverse_playback;
+}
+
+Dictionary MPVPlayer::get_frame_cache_stats() const {
+    uint64_t hits = frame_cache.get_hits();
+    uint64_t misses = frame_cache.get_misses();
+
+    Dictionary stats;
+    stats["frames"] = frame_cache.size();
+    stats["used_bytes"] = (int64_t)frame_cache.get_used_bytes();
+    stats["budget_bytes"] = (int64_t)frame_cache.get_budget();
+    stats["hits"] = (int64_t)hits;
+    stats["misses"] = (int64_t)misses;
+    stats["hit_rate"] = hits + misses > 0 ? (double)hits / (double)(hits + misses) : 0.0;
+    stats["refills"] = (int64_t)jog_refill_count;
+    return stats;
 }
 
 // ==================== Playback State ====================
@@ -969,43 +2889,60 @@ bool MPVPlayer::is_playing() const {
 }
 
 bool MPVPlayer::is_paused() const {
-    return get_property_bool("pause", true);
+    return read_state().paused != 0;
 }
 
 double MPVPlayer::get_time_pos() const {
-    return get_property_double("time-pos", 0.0);
+    // A cached frame on screen may be far from where the frame cache left mpv
+    double shown = shown_frame_pts.load();
+    return shown >= 0.0 ? shown : read_state().time_pos;
 }
 
 double MPVPlayer::get_duration() const {
-    return get_property_double("duration", 0.0);
+    return read_state().duration;
 }
 
 double MPVPlayer::get_percentage_pos() const {
-    return get_property_double("percent-pos", 0.0);
+    return read_state().percent_pos;
+}
+
+Dictionary MPVPlayer::get_state() const {
+    // One consistent snapshot, cheaper than calling the individual getters
+    PlaybackState state = read_state();
+
+    Dictionary result;
+    result["time_pos"] = state.time_pos;
+    result["duration"] = state.duration;
+    result["percent_pos"] = state.percent_pos;
+    result["volume"] = state.volume;
+    result["speed"] = state.speed;
+    result["sub_delay"] = state.sub_delay;
+    result["paused"] = state.paused != 0;
+    result["buffering"] = state.buffering != 0;
+    result["playlist_pos"] = state.playlist_pos;
+    result["playlist_count"] = state.playlist_count;
+    return result;
 }
 
 void MPVPlayer::set_time_pos(double pos) {
-        if (!mpv) {
+        if (!is_initialized()) {
         ERR_PRINT("MPV not initialized");
         return;
     }
-    mpv_set_property_string(mpv, "pause", "yes");
-    mpv_set_property_async(mpv, 0, "time-pos", MPV_FORMAT_DOUBLE, &pos);
-    mpv_set_property_string(mpv, "pause", "no");
+    schedule_seek(pos, SEEK_ABSOLUTE);
 }
 
 void MPVPlayer::pause() {
-    if (!mpv) {
+    if (!is_initialized()) {
         ERR_PRINT("MPV not initialized");
         return;
     }
     
-    const char* cmd[] = {"set", "pause", "yes", nullptr};
-    mpv_command_async(mpv, 0, cmd);
+    queue_property_int(QUEUED_PAUSE, 1);
 }
 
 void MPVPlayer::stop() {
-    if (!mpv) {
+    if (!is_initialized()) {
         ERR_PRINT("MPV not initialized");
         return;
     }
@@ -1018,122 +2955,124 @@ Ref<Texture2D> MPVPlayer::get_texture() const {
     return frame_texture;
 }
 
-Array MPVPlayer::get_audio_tracks() {
-    Array tracks;
+void MPVPlayer::parse_track_list(const mpv_node* node) {
+    // This method runs on the event thread
+    std::vector<TrackInfo> table;
 
-    if (!mpv) {
-        return tracks;
-    }
+    if (node->format == MPV_FORMAT_NODE_ARRAY) {
+        table.reserve(node->u.list->num);
 
-    mpv_node track_list;
-    if (mpv_get_property(mpv, "track-list", MPV_FORMAT_NODE, &track_list) < 0) {
-        return tracks;
-    }
+        for (int i = 0; i < node->u.list->num; i++) {
+            const mpv_node* track = &node->u.list->values[i];
 
-    if (track_list.format != MPV_FORMAT_NODE_ARRAY) {
-        mpv_free_node_contents(&track_list);
-        return tracks;
-    }
+            if (track->format != MPV_FORMAT_NODE_MAP) {
+                continue;
+            }
 
-    for (int i = 0; i < track_list.u.list->num; i++) {
-        mpv_node* track = &track_list.u.list->values[i];
+            TrackInfo info;
+            for (int j = 0; j < track->u.list->num; j++) {
+                const char* key = track->u.list->keys[j];
+                const mpv_node* value = &track->u.list->values[j];
 
-        if (track->format != MPV_FORMAT_NODE_MAP) {
-            continue;
-        }
+                if (strcmp(key, "type") == 0 && value->format == MPV_FORMAT_STRING) {
+                    if (strcmp(value->u.string, "video") == 0) info.kind = TrackInfo::VIDEO;
+                    else if (strcmp(value->u.string, "audio") == 0) info.kind = TrackInfo::AUDIO;
+                    else if (strcmp(value->u.string, "sub") == 0) info.kind = TrackInfo::SUB;
+                }
+                else if (strcmp(key, "id") == 0 && value->format == MPV_FORMAT_INT64) {
+                    info.id = (int)value->u.int64;
+                }
+                else if (strcmp(key, "lang") == 0 && value->format == MPV_FORMAT_STRING) {
+                    info.lang = String::utf8(value->u.string);
+                }
+                else if (strcmp(key, "title") == 0 && value->format == MPV_FORMAT_STRING) {
+                    info.title = String::utf8(value->u.string);
+                }
+                else if (strcmp(key, "codec") == 0 && value->format == MPV_FORMAT_STRING) {
+                    info.codec = String::utf8(value->u.string);
+                }
+                else if (strcmp(key, "selected") == 0 && value->format == MPV_FORMAT_FLAG) {
+                    info.selected = value->u.flag != 0;
+                }
+                else if (strcmp(key, "default") == 0 && value->format == MPV_FORMAT_FLAG) {
+                    info.is_default = value->u.flag != 0;
+                }
+                else if (strcmp(key, "external") == 0 && value->format == MPV_FORMAT_FLAG) {
+                    info.external = value->u.flag != 0;
+                }
+            }
 
-        Dictionary track_info;
-        const char* type = nullptr;
+            if (info.kind != TrackInfo::OTHER) {
+                table.push_back(std::move(info));
+            }
+        }
+    }
 
-        for (int j = 0; j < track->u.list->num; j++) {
-            const char* key = track->u.list->keys[j];
-            mpv_node* value = &track->u.list->values[j];
+    {
+        std::lock_guard<std::mutex> lock(track_mutex);
+        track_table.swap(table);
+    }
+    track_list_version.fetch_add(1, std::memory_order_release);
+}
 
-            if (strcmp(key, "type") == 0 && value->format == MPV_FORMAT_STRING) {
-                type = value->u.string;
-            }
-            else if (strcmp(key, "id") == 0 && value->format == MPV_FORMAT_INT64) {
-                track_info["id"] = (int)value->u.int64;
-            }
-            else if (strcmp(key, "lang") == 0 && value->format == MPV_FORMAT_STRING) {
-                track_info["lang"] = String::utf8(value->u.string);
-            }
-            else if (strcmp(key, "title") == 0 && value->format == MPV_FORMAT_STRING) {
-                track_info["title"] = String::utf8(value->u.string);
-            }
-            else if (strcmp(key, "selected") == 0 && value->format == MPV_FORMAT_FLAG) {
-                track_info["selected"] = (bool)value->u.flag;
+const Array& MPVPlayer::get_cached_tracks(TrackInfo::Kind kind) {
+    // This method runs on the main thread
+    uint64_t version = track_list_version.load(std::memory_order_acquire);
+    if (version != cached_track_version) {
+        static const char* const KIND_NAMES[] = {"video", "audio", "sub"};
+
+        Array tracks[TrackInfo::OTHER];
+        {
+            std::lock_guard<std::mutex> lock(track_mutex);
+            for (const TrackInfo& info : track_table) {
+                Dictionary track_info;
+                track_info["id"] = info.id;
+                track_info["type"] = KIND_NAMES[info.kind];
+                if (!info.lang.is_empty()) {
+                    track_info["lang"] = info.lang;
+                }
+                if (!info.title.is_empty()) {
+                    track_info["title"] = info.title;
+                }
+                if (!info.codec.is_empty()) {
+                    track_info["codec"] = info.codec;
+                }
+                track_info["selected"] = info.selected;
+                track_info["default"] = info.is_default;
+                track_info["external"] = info.external;
+                track_info.make_read_only();
+                tracks[info.kind].append(track_info);
             }
         }
 
-        if (type && strcmp(type, "audio") == 0) {
-            tracks.append(track_info);
+        // Kept read-only so the cache can't be modified in place, the getters hand out copies
+        for (int i = 0; i < TrackInfo::OTHER; i++) {
+            tracks[i].make_read_only();
+            cached_tracks[i] = tracks[i];
         }
+        cached_track_version = version;
     }
+    return cached_tracks[kind];
+}
 
-    mpv_free_node_contents(&track_list);
-    return tracks;
+Array MPVPlayer::get_audio_tracks() {
+    return get_cached_tracks(TrackInfo::AUDIO).duplicate(true);
 }
 
 Array MPVPlayer::get_subtitle_tracks() {
-    Array tracks;
-
-    if (!mpv) {
-        return tracks;
-    }
-
-    mpv_node track_list;
-    if (mpv_get_property(mpv, "track-list", MPV_FORMAT_NODE, &track_list) < 0) {
-        return tracks;
-    }
-
-    if (track_list.format != MPV_FORMAT_NODE_ARRAY) {
-        mpv_free_node_contents(&track_list);
-        return tracks;
-    }
-
-    for (int i = 0; i < track_list.u.list->num; i++) {
-        mpv_node* track = &track_list.u.list->values[i];
-
-        if (track->format != MPV_FORMAT_NODE_MAP) {
-            continue;
-        }
-
-        Dictionary track_info;
-        const char* type = nullptr;
-
-        for (int j = 0; j < track->u.list->num; j++) {
-            const char* key = track->u.list->keys[j];
-            mpv_node* value = &track->u.list->values[j];
-
-            if (strcmp(key, "type") == 0 && value->format == MPV_FORMAT_STRING) {
-                type = value->u.string;
-            }
-            else if (strcmp(key, "id") == 0 && value->format == MPV_FORMAT_INT64) {
-                track_info["id"] = (int)value->u.int64;
-            }
-            else if (strcmp(key, "lang") == 0 && value->format == MPV_FORMAT_STRING) {
-                track_info["lang"] = String::utf8(value->u.string);
-            }
-            else if (strcmp(key, "title") == 0 && value->format == MPV_FORMAT_STRING) {
-                track_info["title"] = String::utf8(value->u.string);
-            }
-            else if (strcmp(key, "selected") == 0 && value->format == MPV_FORMAT_FLAG) {
-                track_info["selected"] = (bool)value->u.flag;
-            }
-        }
+    return get_cached_tracks(TrackInfo::SUB).duplicate(true);
+}
 
-        if (type && strcmp(type, "sub") == 0) {
-            tracks.append(track_info);
-        }
-    }
+Array MPVPlayer::get_video_tracks() {
+    return get_cached_tracks(TrackInfo::VIDEO).duplicate(true);
+}
 
-    mpv_free_node_contents(&track_list);
-    return tracks;
+int64_t MPVPlayer::get_track_list_version() const {
+    return (int64_t)track_list_version.load();
 }
 
 void MPVPlayer::set_native_subtitles_enabled(bool enabled) {
-    if (!mpv) {
+    if (!is_initialized()) {
         ERR_PRINT("MPV not initialized");
         return;
     }
@@ -1150,16 +3089,13 @@ void MPVPlayer::set_native_subtitles_enabled(bool enabled) {
     }
 }
 
-void MPVPlayer::set_subtitle_delay(String seconds) {
-    if (!mpv) {
+void MPVPlayer::set_subtitle_delay(double seconds) {
+    if (!is_initialized()) {
         UtilityFunctions::print("MPV not initialized");
         return;
     }
 
-    //mpv_set_property_string(mpv, "sub-delay", seconds);
-
-    const char* cmd[] = { "set", "sub-delay", seconds.utf8().get_data(), nullptr };
-    mpv_command_async(mpv, 0, cmd);
+    queue_property_double(QUEUED_SUB_DELAY, seconds);
 
     if (debug_level == DEBUG_SIMPLE || debug_level == DEBUG_FULL) {
         UtilityFunctions::print("Subtitle delay set to: ", seconds, " seconds");
@@ -1167,5 +3103,5 @@ void MPVPlayer::set_subtitle_delay(String seconds) {
 }
 
 double MPVPlayer::get_subtitle_delay() const {
-    return get_property_double("sub-delay", 0.0);
+    return read_state().sub_delay;
 }
@@ -9,16 +9,25 @@
 #include <godot_cpp/classes/sub_viewport.hpp>
 #include <godot_cpp/classes/image_texture.hpp>
 #include <godot_cpp/classes/standard_material3d.hpp>
+#include <godot_cpp/variant/packed_float64_array.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
 #include <mpv/client.h>
 #include <mpv/render_gl.h>
 
 #include "enum/debug_flags.h"
+#include "enum/render_backend.h"
+#include "frame_cache.h"
+#include "keyframe_index.h"
 
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <chrono>
+#include <unordered_map>
+#include <memory>
 
 // EGL includes
 #ifdef _WIN32
@@ -45,36 +54,284 @@ private:
     // MPV instance
     mpv_handle* mpv = nullptr;
     mpv_render_context* mpv_ctx = nullptr;
+    int render_backend = RENDER_BACKEND_OPENGL;
     
     // OpenGL resources
     #ifndef __APPLE__
     EGLDisplay egl_display = EGL_NO_DISPLAY;
     EGLSurface egl_surface = EGL_NO_SURFACE;
     EGLContext egl_context = EGL_NO_CONTEXT;
+
+    // What was current on the thread that ran initialize_gl, given back by its release_gl_current
+    EGLDisplay previous_egl_display = EGL_NO_DISPLAY;
+    EGLSurface previous_egl_draw = EGL_NO_SURFACE;
+    EGLSurface previous_egl_read = EGL_NO_SURFACE;
+    EGLContext previous_egl_context = EGL_NO_CONTEXT;
     #endif
 
     GLuint fbo = 0;
     GLuint texture = 0;
+
+    // Asynchronous readback ring (pixel pack buffers guarded by fences)
+    struct ReadbackSlot {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+        uint64_t issued_frame = 0;
+        double pts = -1.0; // Carried over to the frame slot the readback lands in
+    };
+    std::vector<ReadbackSlot> readback_slots;
+    std::atomic<int> readback_buffer_count{3}; // 0 = synchronous glReadPixels
+    int readback_write_index = 0;
+    int readback_pending = 0;
+    std::atomic<int> readback_latency_frames{0}; // Measured frames between render and delivery
+    std::atomic<bool> readback_config_changed{false};
+    uint64_t render_frame_index = 0;
+    bool pbo_supported = false;
+
+    // Render timing, measured on the render thread (render + readback or software render)
+    std::atomic<uint64_t> rendered_frame_count{0};
+    std::atomic<uint64_t> render_time_total_usec{0};
+    std::atomic<uint64_t> last_render_time_usec{0};
+
+    // Frame pacing, mpv's frames are rendered when they are due for the next Godot frame
+    std::atomic<bool> frame_pending{false}; // mpv reported a new frame that has not been rendered yet
+    int64_t frame_due_usec = 0; // mpv_get_time_us() at which the pending frame should be rendered (render thread)
+    bool frame_is_repeat = false; // Render thread only
+    double pending_frame_pts = -1.0; // time-pos when mpv announced the frame about to be rendered, render thread only
+    std::atomic<uint64_t> presented_frame_count{0}; // Godot frames, counted on the main thread
+    uint64_t reported_swap_count = 0; // Render thread only
+    std::atomic<int64_t> present_interval_usec{16667}; // Smoothed Godot frame interval
+    std::chrono::steady_clock::time_point last_present_time; // Main thread only
+    std::atomic<uint64_t> skipped_update_count{0};
+    std::atomic<uint64_t> repeated_frame_count{0};
     
     // Godot resources
-    Ref<Image> frame_image;
     Ref<ImageTexture> frame_texture;
     TextureRect* target_texture_rect = nullptr;
 
     
+    // initialize_async progress, published by the render thread and picked up by _process
+    enum AsyncInitState : int {
+        ASYNC_INIT_IDLE,
+        ASYNC_INIT_PENDING,
+        ASYNC_INIT_SUCCEEDED,
+        ASYNC_INIT_FAILED
+    };
+    std::atomic<int> async_init_state{ASYNC_INIT_IDLE};
+    std::atomic<int64_t> init_time_usec{0};
+
     // Thread management
     std::thread render_thread;
     std::atomic<bool> running{false};
     std::atomic<bool> frame_available{false};
-    std::atomic<bool> texture_needs_update{false};
     std::atomic<bool> has_new_frame{false};
-    std::mutex frame_mutex;
+    std::mutex render_mutex;
+    std::condition_variable render_cv; // Wakes the render thread on mpv updates and shutdown
+    
+    // Frame data, triple-buffered between the render thread and the main thread. The render thread
+    // writes its back slot in place and swaps it with the shared middle slot; the main thread swaps
+    // the middle slot with its front slot when it is marked fresh. Neither side copies or waits, and
+    // each image carries the size it was rendered at.
+    static constexpr int FRAME_SLOT_COUNT = 3;
+    static constexpr uint8_t FRAME_SLOT_INDEX_MASK = 0x3;
+    static constexpr uint8_t FRAME_SLOT_FRESH = 0x4;
+    Ref<Image> frame_slots[FRAME_SLOT_COUNT];
+    double frame_slot_pts[FRAME_SLOT_COUNT] = {-1.0, -1.0, -1.0}; // time-pos of each slot's frame, -1 = not tracked
+    int back_slot = 0; // Render thread only
+    int front_slot = 1; // Main thread only
+    std::atomic<uint8_t> frame_exchange{2}; // Middle slot index, plus FRAME_SLOT_FRESH when it holds an unconsumed frame
+    std::atomic<int> width; // Render size, only changed by the render thread, 0 until known
+    std::atomic<int> height;
+
+    // Render size tracking, the render size follows video-params/dw/dh within the caps below
+    std::mutex render_size_mutex;
+    bool auto_resolution = true;
+    int video_width = 0; // Guarded by render_size_mutex
+    int video_height = 0;
+    Vector2i max_render_size; // (0, 0) = no cap
+    bool render_at_display_size = false;
+    Vector2i display_size_limit; // On-screen size of the target, (0, 0) = unknown
+    Vector2i display_size_hint; // Projected size for 3D targets, set by scripts (main thread)
+    std::atomic<uint64_t> requested_render_size{0}; // (width << 32) | height, 0 = nothing pending
     
-    // Frame data
-    PackedByteArray pixel_data;
-    PackedByteArray pending_frame_data;
-    int width;
-    int height;
+    // Property observation ids (reply_userdata of mpv_observe_property)
+    enum ObservedProperty : uint64_t {
+        OBSERVE_TIME_POS = 1,
+        OBSERVE_PAUSED_FOR_CACHE = 2,
+        OBSERVE_CORE_IDLE = 3,
+        OBSERVE_SUB_TEXT = 4,
+        OBSERVE_PAUSE = 5,
+        OBSERVE_DURATION = 6,
+        OBSERVE_PERCENT_POS = 7,
+        OBSERVE_VOLUME = 8,
+        OBSERVE_SPEED = 9,
+        OBSERVE_SUB_DELAY = 10,
+        OBSERVE_TRACK_LIST = 11,
+        OBSERVE_PLAYLIST_POS = 12,
+        OBSERVE_PLAYLIST_COUNT = 13,
+        OBSERVE_IDLE_ACTIVE = 14
+    };
+
+    // Playback state mirrored from observed properties. The event thread is the only writer and
+    // publishes it through a seqlock, so the getters never take the mpv core lock.
+    struct PlaybackState {
+        double time_pos = 0.0;
+        double duration = 0.0;
+        double percent_pos = 0.0;
+        double volume = 100.0;
+        double speed = 1.0;
+        double sub_delay = 0.0;
+        int64_t paused = 1;
+        int64_t buffering = 0;
+        int64_t playlist_pos = -1;
+        int64_t playlist_count = 0;
+    };
+    static constexpr size_t STATE_WORD_COUNT = sizeof(PlaybackState) / sizeof(uint64_t);
+    static_assert(sizeof(PlaybackState) % sizeof(uint64_t) == 0, "PlaybackState is copied as 64-bit words");
+    std::atomic<uint32_t> state_sequence{0}; // Odd while a write is in progress
+    std::atomic<uint64_t> state_words[STATE_WORD_COUNT] = {};
+    PlaybackState event_state; // Event thread working copy
+    bool event_state_changed = false; // Event thread only
+
+    // Track table parsed from the observed track-list node, replaced as a whole on every change
+    struct TrackInfo {
+        enum Kind : uint8_t {
+            VIDEO,
+            AUDIO,
+            SUB,
+            OTHER
+        };
+        Kind kind = OTHER;
+        int id = 0;
+        bool selected = false;
+        bool is_default = false;
+        bool external = false;
+        String lang;
+        String title;
+        String codec;
+    };
+    std::mutex track_mutex;
+    std::vector<TrackInfo> track_table; // Guarded by track_mutex
+    std::atomic<uint64_t> track_list_version{0}; // Bumped by the event thread on every change
+    std::atomic<bool> idle_active{true}; // Mirrors idle-active, written by the event thread
+    uint64_t cached_track_version = 0; // Main thread only
+    Array cached_tracks[TrackInfo::OTHER]; // Read-only Arrays per kind, rebuilt when the version moves
+
+    // Events decoded by the event thread, drained and coalesced by _process
+    struct PlayerEvent {
+        enum Type : uint8_t {
+            FILE_LOADED,
+            TIME_POS,
+            BUFFERING,
+            SUBTITLE,
+            LOAD_STARTED,
+            LOAD_FAILED,
+            PLAYLIST_POS,
+            SEEK_COMPLETED
+        };
+        Type type = TIME_POS;
+        double value = 0.0; // time-pos, 1.0/0.0 for buffering, the playlist index or the position a seek landed on
+        String text = String(); // Subtitle text, load error or the path of a loaded file
+        int64_t request_id = 0; // load_file request for LOAD_STARTED/LOAD_FAILED
+    };
+
+    // Event thread, woken by mpv_set_wakeup_callback
+    std::thread event_thread;
+    std::atomic<bool> event_running{false};
+    std::atomic<bool> events_pending{false};
+    std::mutex event_mutex;
+    std::condition_variable event_cv;
+    std::vector<PlayerEvent> event_queue; // Guarded by event_mutex
+    std::vector<PlayerEvent> drained_events; // Main thread only, swapped with event_queue
+    bool event_buffering_state = false; // Event thread only
+
+    // Asynchronous loads: reply_userdata of a loadfile command is REPLY_LOAD_FILE | request id
+    static constexpr uint64_t REPLY_LOAD_FILE = 1ull << 62;
+    std::atomic<int64_t> next_load_request_id{0};
+    std::unordered_map<int64_t, int64_t> load_requests_by_entry; // playlist_entry_id -> request id, event thread only
+    int64_t last_playlist_pos = -1; // Main thread only, for playlist_item_changed
+
+    // Seek scheduler. The seek functions only record a target, _process sends it once the previous
+    // seek has finished (PLAYBACK_RESTART), so a scrub bar dragged every frame costs one seek in
+    // flight at a time and the newest target always wins. Main thread only, except seek_in_flight.
+    enum SeekMode : uint8_t {
+        SEEK_ABSOLUTE,
+        SEEK_RELATIVE,
+        SEEK_PERCENT
+    };
+    enum SeekPrecision : uint8_t {
+        SEEK_PRECISION_DEFAULT, // mpv's hr-seek setting decides
+        SEEK_PRECISION_KEYFRAMES, // While scrubbing
+        SEEK_PRECISION_EXACT // The refinement when scrubbing ends
+    };
+    struct SeekRequest {
+        double target = 0.0;
+        SeekMode mode = SEEK_ABSOLUTE;
+        SeekPrecision precision = SEEK_PRECISION_DEFAULT;
+    };
+    static constexpr uint64_t REPLY_SEEK = 1ull << 61;
+    SeekRequest pending_seek;
+    bool seek_pending = false;
+    bool scrubbing = false;
+    SeekRequest scrub_target; // Newest target while scrubbing, sought exactly when it ends
+    bool has_scrub_target = false;
+    std::atomic<bool> seek_in_flight{false}; // Cleared by the event thread
+
+    // Keyframe index of the current local file, rebuilt (or read from its cache) on every file load
+    static constexpr double KEYFRAME_SNAP_TOLERANCE = 0.02; // Exact seeks this close to a keyframe land on it
+    bool keyframe_index_enabled = false;
+    std::unique_ptr<KeyframeIndex> keyframe_index; // Main thread only
+    bool keyframe_index_reported = false;
+
+    // Jog/shuttle. With a frame cache budget, frames shown while stepping stay in memory, so stepping
+    // back through them and reverse playback never reach mpv. Stepping back past the oldest cached
+    // frame refills the cache with one exact seek and forward frame steps instead of a keyframe
+    // decode per step. Main thread only, except shown_frame_pts.
+    enum JogState : uint8_t {
+        JOG_IDLE,
+        JOG_STEPPING, // Waiting for the frame a frame-step produces
+        JOG_SYNCING, // Exact seek back to the cached frame on screen before stepping past it
+        JOG_REFILLING // Exact seek to an earlier point, then frame steps until the cached frames are reached
+    };
+    static constexpr double JOG_FALLBACK_FRAME_DURATION = 1.0 / 25.0;
+    static constexpr int64_t JOG_TIMEOUT_USEC = 3000000;
+    FrameCache frame_cache;
+    JogState jog_state = JOG_IDLE;
+    int jog_cursor = -1; // Cached frame on screen, -1 while the cache is not in use
+    int jog_live = -1; // Cached frame mpv itself shows, -1 if it is elsewhere
+    int jog_pending_steps = 0; // Steps requested while mpv was busy, negative = backwards
+    double jog_step_from = 0.0; // pts of the newest cached frame when the frame-step was sent
+    bool jog_seek_done = false; // The SYNCING/REFILLING seek has finished
+    double jog_refill_target = 0.0; // pts of the oldest cached frame when the refill started
+    std::vector<FrameCache::Frame> jog_refill_frames;
+    std::chrono::steady_clock::time_point jog_deadline;
+    bool reverse_playback = false;
+    double reverse_elapsed = 0.0; // Playback time accumulated towards the next reverse step
+    uint64_t jog_refill_count = 0;
+    std::atomic<double> shown_frame_pts{-1.0}; // pts of a cached frame on screen that mpv isn't showing
+
+    // Send a loadfile command with the per-file options, index is only used by "insert-at" flags
+    int64_t send_loadfile(const String& path, const char* flags, int64_t index = -1);
+
+    // Property writes queued by the setters and flushed once per frame in _process. Each property
+    // has one slot holding its latest value, so repeated writes within a frame collapse into one.
+    enum QueuedProperty : uint8_t {
+        QUEUED_PAUSE,
+        QUEUED_VOLUME,
+        QUEUED_SPEED,
+        QUEUED_AID,
+        QUEUED_SID,
+        QUEUED_SUB_DELAY,
+        QUEUED_ASPECT,
+        QUEUED_LOOP_FILE,
+        QUEUED_PLAYLIST_POS,
+        QUEUED_LOOP_PLAYLIST,
+        QUEUED_PROPERTY_COUNT
+    };
+    std::atomic<uint64_t> queued_values[QUEUED_PROPERTY_COUNT] = {}; // Raw bits of a double or int64
+    std::atomic<uint32_t> queued_mask{0}; // One bit per QueuedProperty with an unsent value
+    std::mutex queued_string_mutex;
+    String queued_loop_file; // Guarded by queued_string_mutex, the only string-valued property
     
     // Streaming support
     bool is_streaming = false;
@@ -99,20 +356,86 @@ public:
     virtual void _process(double delta) override;
     virtual void _ready() override;
     
-    // Initialize the MPV player
-    bool initialize();
+    // Initialize the MPV player, backend is one of RenderBackend
+    bool initialize(int backend = RENDER_BACKEND_OPENGL);
+
+    // Initialize on the render thread instead of the caller's, emits initialized(ok) from _process
+    void initialize_async(int backend = RENDER_BACKEND_OPENGL);
+    bool is_initializing() const;
+
+    // True once initialization succeeded and the render thread is running
+    bool is_initialized() const;
+
+    // Time spent creating mpv, the GL context and the render context
+    int64_t get_init_time_usec() const;
+
+    // Stop playback and restore the defaults a previous user may have changed, keeping mpv and
+    // the render context alive (used by MPVPlayerPool)
+    void reset_for_reuse();
+
+    // Per-frame upkeep for a player the pool holds outside the scene tree, in place of _process:
+    // finishes initialize_async without emitting initialized, counts the frame as presented,
+    // and drops published frames and decoded events so the next user doesn't receive them
+    void process_pooled();
+
+    // mpv has no file open, e.g. once the stop sent by reset_for_reuse went through
+    bool is_idle_active() const;
     
     // Load and play a video file
-    void load_file(const String& path);
+    // Starts loading asynchronously, returns the request id carried by load_started/load_failed
+    int64_t load_file(const String& path);
+
+    // Playlist, backed by mpv's own so the next item is prefetched and played gaplessly.
+    // Adding returns a load request id like load_file and starts playback if nothing is playing.
+    int64_t playlist_append(const String& path);
+    int64_t playlist_insert(int index, const String& path);
+    void playlist_remove(int index);
+    // Move the item at from so that it ends up at index to
+    void playlist_move(int from, int to);
+    // Remove every item except the one playing, stop() ends that one too
+    void playlist_clear();
+    void playlist_next();
+    void playlist_prev();
+    void set_playlist_index(int index);
+    // -1 when nothing is playing
+    int get_playlist_index() const;
+    int get_playlist_count() const;
+    void set_playlist_loop(bool enabled);
     void set_resolution(int new_width, int new_height);
 
-    // Get track information
+    // Render size follows the video's display size (on by default, set_resolution turns it off)
+    void set_auto_resolution(bool enabled);
+    bool get_auto_resolution();
+    void set_max_render_size(Vector2i size);
+    Vector2i get_max_render_size();
+
+    // Cap the render size to the on-screen size of the target TextureRect, or of the display size hint
+    void set_render_at_display_size(bool enabled);
+    bool get_render_at_display_size();
+
+    // Projected on-screen size in pixels of a 3D surface showing the video, used when no TextureRect is set
+    void set_display_size_hint(Vector2i size);
+    Vector2i get_display_size_hint();
+
+    // Readback pipeline depth (number of pixel buffers in flight, 0 = synchronous)
+    void set_readback_buffer_count(int count);
+    int get_readback_buffer_count() const;
+    int get_readback_latency() const;
+
+    // Render backend in use and render timing, for comparing backends
+    int get_render_backend() const;
+    Dictionary get_render_stats() const;
+
+    // Get track information. Built from a cache refreshed only when the track list changes, each
+    // call returns a copy the caller may sort or modify.
     Array get_audio_tracks();
     Array get_subtitle_tracks();
+    Array get_video_tracks();
+    int64_t get_track_list_version() const;
 
     void set_native_subtitles_enabled(bool enabled);
 
-    void set_subtitle_delay(String seconds);
+    void set_subtitle_delay(double seconds);
     double get_subtitle_delay() const;
 
     // Set the target TextureRect
@@ -120,19 +443,51 @@ public:
     
     double get_content_aspect_ratio();
     void play();
-    void set_volume(String value);
+    void set_volume(double value);
     double get_volume() const;
     void set_aspect_ratio(String ratio);
     void restart();
-    void set_audio_track(String id);
-    void set_subtitle_track(String id);
+    void set_audio_track(int id); // 0 = off, -1 = auto
+    void set_subtitle_track(int id);
     void add_subtitle_file(String path, String title, String lang);
-    void set_playback_speed(String speed);
+    void set_playback_speed(double speed);
     void set_repeat_file(String value);
     void set_time_pos(double pos);
     void seek_content_pos(String pos);
     void seek(String seconds, bool relative);
     void seek_to_percentage(String pos);
+
+    // While scrubbing, seeks jump to keyframes, ending it seeks exactly to the last target.
+    // seek_completed(pos) is emitted once the newest requested seek has finished.
+    void set_scrubbing(bool enabled);
+    bool is_scrubbing() const;
+
+    // Index the keyframes of local files in the background when they load, cached under user://.
+    // Once the index is ready, scrubbing seeks snap to the nearest keyframe and exact seeks that
+    // are within a frame of one become keyframe seeks. keyframe_index_ready(count) reports it.
+    void set_keyframe_index_enabled(bool enabled);
+    bool get_keyframe_index_enabled() const;
+    bool is_keyframe_index_ready() const;
+    PackedFloat64Array get_keyframes() const;
+    // -1 while there is no index
+    double get_nearest_keyframe(double time) const;
+
+    // Step one frame, pausing playback. Without a frame cache these are mpv's frame-step and
+    // frame-back-step; with one, steps through frames already shown are served from memory.
+    void frame_step();
+    void frame_back_step();
+
+    // Memory for the frame cache in MiB, 0 (the default) disables it. Frames are kept at the
+    // render size. Changing the budget drops the cached frames.
+    void set_frame_cache_budget_mb(int megabytes);
+    int get_frame_cache_budget_mb() const;
+
+    // Play backwards from the frame cache at the current speed, needs a frame cache budget
+    void set_reverse_playback(bool enabled);
+    bool is_reverse_playback() const;
+
+    // Frames, memory use and the share of steps served from memory
+    Dictionary get_frame_cache_stats() const;
     void pause();
     void stop();
 
@@ -142,13 +497,14 @@ public:
     double get_time_pos() const;
     double get_duration() const;
     double get_percentage_pos() const;
+    Dictionary get_state() const;
     
-    // Get the current frame texture
+    // Get the current frame texture, null until the first frame is uploaded
     Ref<Texture2D> get_texture() const;
     
-    // Get video dimensions
-    int get_width() const { return width; }
-    int get_height() const { return height; }
+    // Get the render size, 0x0 until the video size is known
+    int get_width() const { return width.load(); }
+    int get_height() const { return height.load(); }
 
     unsigned int get_debug_level();
     void set_debug_level(unsigned int);
@@ -157,16 +513,80 @@ public:
     static int get_debug_none() {return DEBUG_NONE;}
     static int get_debug_simple() {return DEBUG_SIMPLE;}
     static int get_debug_full() {return DEBUG_FULL;}
+    static int get_render_backend_opengl() {return RENDER_BACKEND_OPENGL;}
+    static int get_render_backend_software() {return RENDER_BACKEND_SOFTWARE;}
+
+    // Read throughput of res:// and user:// files as mpv sees them, against FileAccess and direct reads
+    static Dictionary benchmark_stream(const String& path);
     
 private:
+    // Stop the threads and hand mpv and the GL/EGL objects to the PlayerReaper, runs once
+    void shutdown();
+    bool is_shut_down = false;
+
+    // Create mpv, the GL context (made current on the calling thread) and the render context
+    bool create_player(int backend);
+
+    // Body of the render thread started by initialize_async: create_player, then render_loop
+    void initialize_and_render(int backend);
+
     // Initialize OpenGL for rendering
     bool initialize_gl();
+
+    // Pixel buffer readback ring
+    bool allocate_readback_buffers();
+    void free_readback_buffers();
+    void queue_readback(double pts);
+    bool collect_readback();
+
+    // GL context ownership, the context is only ever current on the render thread once initialized
+    bool make_gl_current();
+    void release_gl_current();
+    void destroy_render_context();
+
+    // Render one frame into the FBO and start reading it back (render thread)
+    void render_frame();
+
+    // Frame pacing (render thread): query mpv's next frame and report Godot's frames as swaps
+    bool is_frame_due();
+    void report_swaps();
+
+    // Recompute the render size from the video size and caps, and hand it to the render thread
+    void update_render_size();
+    void request_render_size(int new_width, int new_height);
+
+    // Reallocate the FBO and readback buffers to the requested size (render thread)
+    void apply_render_size();
+
+    // Track the on-screen size of the target for render_at_display_size (main thread)
+    void update_display_size_limit();
+    Vector2i measure_display_size();
+
+    // Render one frame with the software renderer straight into the back slot (render thread)
+    void render_frame_sw();
+
+    // Back slot pixels at the current render size, reallocated only when the size changed (render thread)
+    uint8_t* get_back_frame();
+
+    // Hand the back slot and its pts to the main thread, replacing a frame it hasn't picked up yet (render thread)
+    void publish_frame(double pts);
+
+    // Swap in the newest published frame, returns false if there is none (main thread)
+    bool take_frame();
+
+    // Count a Godot frame as presented, the render thread reports it to mpv as a swap (main thread)
+    void count_presented_frame();
+
+    void start_render_thread();
+    void stop_render_thread();
+    void wake_render_thread();
     
     // Update the texture with the latest frame data
     void update_texture();
     
     // Update the texture on the main thread
     void _update_texture_internal();
+    void upload_frame(const Ref<Image>& frame_image);
         
     // MPV render update callback
     static void on_mpv_render_update(void* ctx);
@@ -176,9 +596,55 @@ private:
     int64_t get_property_int(const char* name, int64_t default_value = 0) const;
     String get_property_string(const char* name, const String& default_value = "") const;
     bool get_property_bool(const char* name, bool default_value = false) const;
+
+    // Track table: parsed on the event thread, turned into Arrays lazily on the main thread
+    void parse_track_list(const mpv_node* node);
+    const Array& get_cached_tracks(TrackInfo::Kind kind);
+
+    // Playback state snapshot, written by the event thread and read from any thread
+    void publish_state(const PlaybackState& state);
+    PlaybackState read_state() const;
+
+    // Property write queue. The setters that only queue check is_initialized() rather than the mpv
+    // pointer, which initialize_async writes on the render thread, so they may be called from any thread.
+    void queue_property_double(QueuedProperty property, double value);
+    void queue_property_int(QueuedProperty property, int64_t value);
+    void flush_queued_properties();
+
+    // Seek scheduler (main thread)
+    void schedule_seek(double target, SeekMode mode);
+    double get_seek_destination() const;
+    void flush_pending_seek();
+
+    // Keyframe index (main thread)
+    void update_keyframe_index(const String& path);
+    const KeyframeIndex* get_ready_keyframe_index() const; // nullptr unless ready and not empty
+    void plan_keyframe_seek(SeekRequest& request, const KeyframeIndex& index) const;
+
+    // Jog/shuttle (main thread)
+    void reset_jog();
+    bool seed_jog();
+    void step_jog(int direction);
+    void show_jog_frame(int index);
+    void capture_jog_frame();
+    void update_jog(double delta);
+    void send_jog_step();
+    void send_jog_seek(double pts);
+    bool start_jog_refill();
+    void finish_jog_refill();
     
     // Render loop (runs in a separate thread)
     void render_loop();
+
+    // Event loop (runs in a separate thread), decodes mpv events into event_queue
+    void event_loop();
+    void handle_mpv_event(mpv_event* event, std::vector<PlayerEvent>& out);
+    void start_event_thread();
+    void stop_event_thread();
+    static void on_mpv_wakeup(void* ctx);
+
+    // Emit signals for the events queued since the last frame (main thread)
+    void drain_events();
     
     // Function to get OpenGL function pointers for MPV
     static void* get_proc_address_mpv(void* ctx, const char* name) {
@@ -0,0 +1,291 @@
+#include "mpv_player_pool.h"
+
+#include <godot_cpp/classes/class_db_singleton.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+// A second of generated 4:2:0 video, the format most real files decode to
+static const char* PREWARM_SOURCE = "av://lavfi:testsrc2=size=64x64:rate=25:duration=1,format=yuv420p";
+static const int64_t PREWARM_TIMEOUT_USEC = 2000000;
+
+MPVPlayerPool* MPVPlayerPool::singleton = nullptr;
+
+void MPVPlayerPool::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_pool_size", "size"), &MPVPlayerPool::set_pool_size);
+    ClassDB::bind_method(D_METHOD("get_pool_size"), &MPVPlayerPool::get_pool_size);
+    ClassDB::bind_method(D_METHOD("set_render_backend", "backend"), &MPVPlayerPool::set_render_backend);
+    ClassDB::bind_method(D_METHOD("get_render_backend"), &MPVPlayerPool::get_render_backend);
+    ClassDB::bind_method(D_METHOD("set_prewarm_shaders", "enabled"), &MPVPlayerPool::set_prewarm_shaders);
+    ClassDB::bind_method(D_METHOD("get_prewarm_shaders"), &MPVPlayerPool::get_prewarm_shaders);
+    ClassDB::bind_method(D_METHOD("warm_up"), &MPVPlayerPool::warm_up);
+    ClassDB::bind_method(D_METHOD("acquire"), &MPVPlayerPool::acquire);
+    ClassDB::bind_method(D_METHOD("release", "player"), &MPVPlayerPool::release);
+    ClassDB::bind_method(D_METHOD("clear"), &MPVPlayerPool::clear);
+    ClassDB::bind_method(D_METHOD("get_stats"), &MPVPlayerPool::get_stats);
+}
+
+MPVPlayerPool* MPVPlayerPool::get_singleton() {
+    return singleton;
+}
+
+MPVPlayerPool::MPVPlayerPool() {
+    singleton = this;
+}
+
+MPVPlayerPool::~MPVPlayerPool() {
+    clear();
+    if (singleton == this) {
+        singleton = nullptr;
+    }
+}
+
+void MPVPlayerPool::set_pool_size(int size) {
+    pool_size = std::max(size, 0);
+
+    // Shrink right away, growing waits for warm_up() or the next acquire()
+    while ((int)idle_players.size() > pool_size) {
+        memdelete(idle_players.back().player);
+        idle_players.pop_back();
+    }
+}
+
+int MPVPlayerPool::get_pool_size() const {
+    return pool_size;
+}
+
+void MPVPlayerPool::set_render_backend(int backend) {
+    if (backend == render_backend) {
+        return;
+    }
+    render_backend = backend;
+    clear();
+}
+
+int MPVPlayerPool::get_render_backend() const {
+    return render_backend;
+}
+
+void MPVPlayerPool::set_prewarm_shaders(bool enabled) {
+    prewarm_shaders = enabled;
+}
+
+bool MPVPlayerPool::get_prewarm_shaders() const {
+    return prewarm_shaders;
+}
+
+void MPVPlayerPool::warm_up() {
+    while ((int)idle_players.size() < pool_size) {
+        spawn_player();
+    }
+}
+
+void MPVPlayerPool::spawn_player() {
+    PooledPlayer entry;
+    entry.player = memnew(MPVPlayer);
+    entry.spawned = std::chrono::steady_clock::now();
+    entry.player->initialize_async(render_backend);
+    idle_players.push_back(entry);
+
+    // Pooled players are outside the scene tree, so the pool watches their progress itself
+    set_polling(true);
+}
+
+void MPVPlayerPool::mark_ready(PooledPlayer& entry) {
+    entry.state = PooledPlayer::READY;
+
+    uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - entry.spawned).count();
+    last_warm_up_usec = elapsed;
+    warm_up_total_usec += elapsed;
+    init_total_usec += entry.player->get_init_time_usec();
+    warmed_count++;
+}
+
+void MPVPlayerPool::set_polling(bool enabled) {
+    if (enabled == polling) {
+        return;
+    }
+
+    SceneTree* tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+    if (!tree) {
+        return;
+    }
+
+    Callable poll = callable_mp(this, &MPVPlayerPool::_poll);
+    if (enabled) {
+        tree->connect("process_frame", poll);
+    } else {
+        tree->disconnect("process_frame", poll);
+    }
+    polling = enabled;
+}
+
+void MPVPlayerPool::_poll() {
+    // Runs once per frame while any pooled player is still warming up or resetting
+    bool warming = false;
+    auto now = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < idle_players.size();) {
+        PooledPlayer& entry = idle_players[i];
+        MPVPlayer* player = entry.player;
+
+        // Players outside the tree get no _process, this stands in for it
+        player->process_pooled();
+
+        if (entry.state == PooledPlayer::INITIALIZING) {
+            if (player->is_initializing()) {
+                warming = true;
+                i++;
+                continue;
+            }
+
+            if (!player->is_initialized()) {
+                UtilityFunctions::print("MPVPlayerPool: failed to initialize a pooled player");
+                memdelete(player);
+                idle_players.erase(idle_players.begin() + i);
+                continue;
+            }
+
+            if (prewarm_shaders) {
+                player->load_file(PREWARM_SOURCE);
+                entry.state = PooledPlayer::PREWARMING;
+                entry.prewarm_started = now;
+            } else {
+                mark_ready(entry);
+            }
+        }
+
+        if (entry.state == PooledPlayer::PREWARMING) {
+            Dictionary stats = player->get_render_stats();
+            int64_t frames = stats["frames_rendered"];
+            int64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - entry.prewarm_started).count();
+
+            if (frames > 0 || elapsed > PREWARM_TIMEOUT_USEC) {
+                player->reset_for_reuse();
+                entry.state = PooledPlayer::RESETTING;
+            } else {
+                warming = true;
+            }
+        }
+
+        if (entry.state == PooledPlayer::RESETTING) {
+            // The stop's END_FILE and property changes come before mpv goes idle, and were just
+            // dropped. An idle player had nothing to stop.
+            if (player->is_idle_active()) {
+                if (entry.warming_up) {
+                    mark_ready(entry);
+                } else {
+                    entry.state = PooledPlayer::READY;
+                }
+            } else {
+                warming = true;
+            }
+        }
+
+        i++;
+    }
+
+    if (!warming) {
+        set_polling(false);
+    }
+}
+
+MPVPlayer* MPVPlayerPool::acquire() {
+    MPVPlayer* player = nullptr;
+
+    for (size_t i = 0; i < idle_players.size(); i++) {
+        if (idle_players[i].state == PooledPlayer::READY) {
+            player = idle_players[i].player;
+            idle_players.erase(idle_players.begin() + i);
+            break;
+        }
+    }
+
+    if (player) {
+        // Whatever arrived since the last poll belongs to no one
+        player->process_pooled();
+        hit_count++;
+    } else {
+        // Nothing warm yet, pay the full initialization like a player created without the pool
+        miss_count++;
+        player = memnew(MPVPlayer);
+        if (!player->initialize(render_backend)) {
+            memdelete(player);
+            player = nullptr;
+        }
+    }
+
+    // Refill in the background for the next caller
+    warm_up();
+    return player;
+}
+
+void MPVPlayerPool::release(MPVPlayer* player) {
+    if (!player) {
+        return;
+    }
+
+    Node* parent = player->get_parent();
+    if (parent) {
+        parent->remove_child(player);
+    }
+
+    if ((int)idle_players.size() >= pool_size || !player->is_initialized()) {
+        memdelete(player);
+        return;
+    }
+
+    disconnect_player_signals(player);
+    player->reset_for_reuse();
+
+    PooledPlayer entry;
+    entry.player = player;
+    entry.state = PooledPlayer::RESETTING;
+    entry.warming_up = false;
+    idle_players.push_back(entry);
+    set_polling(true);
+}
+
+void MPVPlayerPool::clear() {
+    for (PooledPlayer& entry : idle_players) {
+        memdelete(entry.player);
+    }
+    idle_players.clear();
+    set_polling(false);
+}
+
+void MPVPlayerPool::disconnect_player_signals(MPVPlayer* player) {
+    // Only MPVPlayer's own signals, Node's are left to the engine
+    TypedArray<Dictionary> signals = ClassDBSingleton::get_singleton()->class_get_signal_list("MPVPlayer", true);
+    for (int64_t i = 0; i < signals.size(); i++) {
+        Dictionary signal_info = signals[i];
+        StringName name = signal_info["name"];
+
+        TypedArray<Dictionary> connections = player->get_signal_connection_list(name);
+        for (int64_t j = 0; j < connections.size(); j++) {
+            Dictionary connection = connections[j];
+            player->disconnect(name, connection["callable"]);
+        }
+    }
+}
+
+Dictionary MPVPlayerPool::get_stats() const {
+    int ready = 0;
+    for (const PooledPlayer& entry : idle_players) {
+        if (entry.state == PooledPlayer::READY) {
+            ready++;
+        }
+    }
+
+    Dictionary stats;
+    stats["hits"] = (int64_t)hit_count;
+    stats["misses"] = (int64_t)miss_count;
+    stats["hit_rate"] = hit_count + miss_count > 0 ? (double)hit_count / (double)(hit_count + miss_count) : 0.0;
+    stats["idle"] = ready;
+    stats["warming"] = (int)idle_players.size() - ready;
+    stats["last_warm_up_usec"] = (int64_t)last_warm_up_usec;
+    stats["average_warm_up_usec"] = warmed_count > 0 ? (double)warm_up_total_usec / (double)warmed_count : 0.0;
+    stats["average_init_usec"] = warmed_count > 0 ? (double)init_total_usec / (double)warmed_count : 0.0;
+    return stats;
+}
@@ -0,0 +1,99 @@
+#ifndef MPV_PLAYER_POOL_H
+#define MPV_PLAYER_POOL_H
+
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+
+#include "mpv_player.h"
+
+#include <chrono>
+#include <vector>
+
+using namespace godot;
+
+// Engine singleton keeping a few initialized players ready, so short-lived players (previews,
+// thumbnails) skip mpv_initialize, EGL bring-up, render context creation and the first shader
+// compile. Players are warmed with initialize_async and polled once per frame in place of their
+// _process, until a released player's stop has gone through; the pool itself is only used from the
+// main thread.
+class MPVPlayerPool : public Object {
+    GDCLASS(MPVPlayerPool, Object);
+
+private:
+    static MPVPlayerPool* singleton;
+
+    struct PooledPlayer {
+        enum State : uint8_t {
+            INITIALIZING,
+            PREWARMING, // Rendering a tiny generated clip to compile mpv's shaders
+            RESETTING, // Waiting for the stop sent by reset_for_reuse, its events are dropped
+            READY
+        };
+        MPVPlayer* player = nullptr;
+        State state = INITIALIZING;
+        bool warming_up = true; // Counted in the warm-up statistics once ready, false for released players
+        std::chrono::steady_clock::time_point spawned;
+        std::chrono::steady_clock::time_point prewarm_started;
+    };
+    std::vector<PooledPlayer> idle_players; // Not in the scene tree, owned by the pool
+
+    int pool_size = 2;
+    int render_backend = RENDER_BACKEND_OPENGL;
+    bool prewarm_shaders = true;
+    bool polling = false;
+
+    // Statistics
+    uint64_t hit_count = 0;
+    uint64_t miss_count = 0;
+    uint64_t warmed_count = 0;
+    uint64_t warm_up_total_usec = 0;
+    uint64_t last_warm_up_usec = 0;
+    uint64_t init_total_usec = 0;
+
+    void spawn_player();
+    void mark_ready(PooledPlayer& entry);
+    void set_polling(bool enabled);
+    void _poll();
+
+    // Disconnect everything the previous user connected to the player's signals
+    static void disconnect_player_signals(MPVPlayer* player);
+
+protected:
+    static void _bind_methods();
+
+public:
+    static MPVPlayerPool* get_singleton();
+
+    MPVPlayerPool();
+    ~MPVPlayerPool();
+
+    // Number of idle players to keep ready
+    void set_pool_size(int size);
+    int get_pool_size() const;
+
+    // Backend of pooled players, changing it drops the idle ones
+    void set_render_backend(int backend);
+    int get_render_backend() const;
+
+    // Render a short generated clip after initialization so the first real frame skips shader compilation
+    void set_prewarm_shaders(bool enabled);
+    bool get_prewarm_shaders() const;
+
+    // Start initializing players until pool_size are idle or warming up
+    void warm_up();
+
+    // Hand out a ready player (hit) or initialize a new one synchronously (miss), refilling the pool
+    MPVPlayer* acquire();
+
+    // Take a player back: it is removed from its parent, stopped and reset, or freed if the pool is full.
+    // The caller must not free it afterwards.
+    void release(MPVPlayer* player);
+
+    // Free every idle player
+    void clear();
+
+    Dictionary get_stats() const;
+};
+
+#endif // MPV_PLAYER_POOL_H
@@ -0,0 +1,743 @@
+#include "mpv_thumbnailer.h"
+#include "godot_stream.h"
+#include "player_reaper.h"
+#include "thumbnail_workers.h"
+
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <mpv/client.h>
+#include <mpv/render.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+
+static const char* CACHE_DIR = "user://thumbnails";
+static const uint32_t CACHE_MAGIC = 0x5456504D; // "MPVT"
+static const uint32_t CACHE_VERSION = 1;
+static const uint64_t CACHE_HEADER_SIZE = 4096; // Pixels start on a page boundary, so the file can be mapped as is
+
+static const int MAX_ATLAS_SIZE = 8192; // Largest texture every renderer accepts
+static const uint64_t UPLOAD_INTERVAL_USEC = 250000;
+static const double LOAD_TIMEOUT = 15.0;
+static const double SEEK_TIMEOUT = 5.0;
+
+// One headless mpv instance: no audio, no subtitles, no GL, frames rendered by mpv's software
+// renderer straight at tile size. Its methods run on a worker thread and only use the client API,
+// every render context call goes through ThumbnailWorkers::run_on_render_thread().
+struct MPVThumbnailer::HeadlessDecoder {
+    mpv_handle* mpv = nullptr;
+    mpv_render_context* render_context = nullptr;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool update_pending = false; // Guarded by mutex
+
+    static void on_render_update(void* ctx) {
+        // Called from an mpv thread, which must not call back into mpv
+        HeadlessDecoder* decoder = static_cast<HeadlessDecoder*>(ctx);
+        {
+            std::lock_guard<std::mutex> lock(decoder->mutex);
+            decoder->update_pending = true;
+        }
+        decoder->cv.notify_one();
+    }
+
+    bool open(const CharString& path, const std::atomic<bool>& cancelled) {
+        mpv = mpv_create();
+        if (!mpv) {
+            return false;
+        }
+
+        mpv_set_option_string(mpv, "config", "no");
+        mpv_set_option_string(mpv, "load-scripts", "no");
+        mpv_set_option_string(mpv, "ytdl", "no");
+        mpv_set_option_string(mpv, "vo", "libmpv");
+        mpv_set_option_string(mpv, "aid", "no");
+        mpv_set_option_string(mpv, "sid", "no");
+        mpv_set_option_string(mpv, "pause", "yes");
+        mpv_set_option_string(mpv, "keep-open", "yes");
+        mpv_set_option_string(mpv, "osd-level", "0");
+        // Tiles are tiny and land on keyframes, so decode as cheaply as possible
+        mpv_set_option_string(mpv, "hwdec", "no");
+        mpv_set_option_string(mpv, "hr-seek", "no");
+        mpv_set_option_string(mpv, "vd-lavc-threads", "2");
+        mpv_set_option_string(mpv, "vd-lavc-skiploopfilter", "all");
+        mpv_set_option_string(mpv, "scale", "bilinear");
+        mpv_set_option_string(mpv, "network-timeout", "15");
+
+        if (mpv_initialize(mpv) < 0) {
+            return false;
+        }
+        GodotStream::register_protocols(mpv);
+
+        ThumbnailWorkers::get_singleton().run_on_render_thread([this]() {
+            mpv_render_param params[] = {
+                {MPV_RENDER_PARAM_API_TYPE, const_cast<char*>(MPV_RENDER_API_TYPE_SW)},
+                {MPV_RENDER_PARAM_INVALID, nullptr}
+            };
+            if (mpv_render_context_create(&render_context, mpv, params) < 0) {
+                render_context = nullptr;
+                return;
+            }
+            mpv_render_context_set_update_callback(render_context, &HeadlessDecoder::on_render_update, this);
+        });
+        if (!render_context) {
+            return false;
+        }
+
+        const char* cmd[] = {"loadfile", path.get_data(), nullptr};
+        if (mpv_command(mpv, cmd) < 0) {
+            return false;
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(LOAD_TIMEOUT);
+        while (!cancelled.load() && std::chrono::steady_clock::now() < deadline) {
+            mpv_event* event = mpv_wait_event(mpv, 0.1);
+            if (event->event_id == MPV_EVENT_FILE_LOADED) {
+                return true;
+            }
+            if (event->event_id == MPV_EVENT_END_FILE || event->event_id == MPV_EVENT_SHUTDOWN) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    // Seek to a keyframe and render the frame shown there, false if mpv doesn't get there in time
+    bool render_at(double time, const Vector2i& size, uint8_t* pixels, const std::atomic<bool>& cancelled) {
+        ThumbnailWorkers& workers = ThumbnailWorkers::get_singleton();
+
+        // Whatever was pending belongs to the previous position
+        workers.run_on_render_thread([this]() { mpv_render_context_update(render_context); });
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            update_pending = false;
+        }
+
+        CharString target = String::num(time, 3).utf8();
+        const char* cmd[] = {"seek", target.get_data(), "absolute+keyframes", nullptr};
+        if (mpv_command(mpv, cmd) < 0) {
+            return false;
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(SEEK_TIMEOUT);
+        bool restarted = false;
+        while (!restarted) {
+            if (cancelled.load() || std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            mpv_event* event = mpv_wait_event(mpv, 0.1);
+            if (event->event_id == MPV_EVENT_PLAYBACK_RESTART) {
+                restarted = true;
+            } else if (event->event_id == MPV_EVENT_END_FILE || event->event_id == MPV_EVENT_SHUTDOWN) {
+                return false;
+            }
+        }
+
+        int sw_size[2] = {size.x, size.y};
+        size_t sw_stride = static_cast<size_t>(size.x) * 4;
+        mpv_render_param params[] = {
+            {MPV_RENDER_PARAM_SW_SIZE, sw_size},
+            {MPV_RENDER_PARAM_SW_FORMAT, const_cast<char*>("rgb0")},
+            {MPV_RENDER_PARAM_SW_STRIDE, &sw_stride},
+            {MPV_RENDER_PARAM_SW_POINTER, pixels},
+            {MPV_RENDER_PARAM_INVALID, nullptr}
+        };
+
+        // A paused seek still presents the frame it landed on, the update callback says when
+        enum { NO_FRAME, RENDERED, RENDER_FAILED } result = NO_FRAME;
+        auto render_frame = [this, &params, &result]() {
+            if (mpv_render_context_update(render_context) & MPV_RENDER_UPDATE_FRAME) {
+                result = mpv_render_context_render(render_context, params) < 0 ? RENDER_FAILED : RENDERED;
+            }
+        };
+        while (true) {
+            workers.run_on_render_thread(render_frame);
+            if (result != NO_FRAME) {
+                break;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait_for(lock, std::chrono::milliseconds(100), [this] { return update_pending; });
+            update_pending = false;
+            if (cancelled.load() || std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+        }
+        if (result == RENDER_FAILED) {
+            return false;
+        }
+
+        // rgb0 leaves the padding byte undefined, Godot reads it as alpha
+        size_t pixel_count = static_cast<size_t>(size.x) * size.y;
+        for (size_t i = 0; i < pixel_count; i++) {
+            pixels[i * 4 + 3] = 255;
+        }
+        return true;
+    }
+
+    ~HeadlessDecoder() {
+        // The render context is freed where it was created, it must go before its mpv handle
+        if (render_context) {
+            ThumbnailWorkers::get_singleton().run_on_render_thread([this]() {
+                mpv_render_context_set_update_callback(render_context, nullptr, nullptr);
+                mpv_render_context_free(render_context);
+            });
+            render_context = nullptr;
+        }
+
+        // Tearing mpv down waits for its demuxer, which the reaper can do off this thread
+        PlayerResources resources;
+        resources.mpv = mpv;
+        resources.uses_gl = false;
+        if (resources.mpv) {
+            PlayerReaper::get_singleton().reap(std::move(resources));
+        }
+    }
+};
+
+void MPVThumbnailer::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_interval", "seconds"), &MPVThumbnailer::set_interval);
+    ClassDB::bind_method(D_METHOD("get_interval"), &MPVThumbnailer::get_interval);
+    ClassDB::bind_method(D_METHOD("set_tile_size", "size"), &MPVThumbnailer::set_tile_size);
+    ClassDB::bind_method(D_METHOD("get_tile_size"), &MPVThumbnailer::get_tile_size);
+    ClassDB::bind_method(D_METHOD("set_max_thumbnails", "count"), &MPVThumbnailer::set_max_thumbnails);
+    ClassDB::bind_method(D_METHOD("get_max_thumbnails"), &MPVThumbnailer::get_max_thumbnails);
+    ClassDB::bind_method(D_METHOD("set_worker_count", "count"), &MPVThumbnailer::set_worker_count);
+    ClassDB::bind_method(D_METHOD("get_worker_count"), &MPVThumbnailer::get_worker_count);
+    ClassDB::bind_method(D_METHOD("generate", "path"), &MPVThumbnailer::generate);
+    ClassDB::bind_method(D_METHOD("cancel"), &MPVThumbnailer::cancel);
+    ClassDB::bind_method(D_METHOD("is_ready"), &MPVThumbnailer::is_ready);
+    ClassDB::bind_method(D_METHOD("get_progress"), &MPVThumbnailer::get_progress);
+    ClassDB::bind_method(D_METHOD("get_thumbnail_count"), &MPVThumbnailer::get_thumbnail_count);
+    ClassDB::bind_method(D_METHOD("get_thumbnail_interval"), &MPVThumbnailer::get_thumbnail_interval);
+    ClassDB::bind_method(D_METHOD("get_atlas_texture"), &MPVThumbnailer::get_atlas_texture);
+    ClassDB::bind_method(D_METHOD("get_thumbnail", "time"), &MPVThumbnailer::get_thumbnail);
+
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "interval"), "set_interval", "get_interval");
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "tile_size"), "set_tile_size", "get_tile_size");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "max_thumbnails"), "set_max_thumbnails", "get_max_thumbnails");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "worker_count"), "set_worker_count", "get_worker_count");
+
+    ADD_SIGNAL(MethodInfo("thumbnails_progress", PropertyInfo(Variant::INT, "done"), PropertyInfo(Variant::INT, "total")));
+    ADD_SIGNAL(MethodInfo("thumbnails_ready"));
+    ADD_SIGNAL(MethodInfo("thumbnails_failed", PropertyInfo(Variant::STRING, "error")));
+}
+
+MPVThumbnailer::MPVThumbnailer() {
+}
+
+MPVThumbnailer::~MPVThumbnailer() {
+    stop_generation();
+}
+
+void MPVThumbnailer::set_interval(double seconds) {
+    interval = std::max(seconds, 0.1);
+}
+
+double MPVThumbnailer::get_interval() const {
+    return interval;
+}
+
+void MPVThumbnailer::set_tile_size(Vector2i size) {
+    tile_size = Vector2i(std::clamp(size.x, 16, 1024), std::clamp(size.y, 16, 1024));
+}
+
+Vector2i MPVThumbnailer::get_tile_size() const {
+    return tile_size;
+}
+
+void MPVThumbnailer::set_max_thumbnails(int count) {
+    max_thumbnails = std::max(count, 1);
+}
+
+int MPVThumbnailer::get_max_thumbnails() const {
+    return max_thumbnails;
+}
+
+void MPVThumbnailer::set_worker_count(int count) {
+    worker_count = std::clamp(count, 1, 8);
+}
+
+int MPVThumbnailer::get_worker_count() const {
+    return worker_count;
+}
+
+void MPVThumbnailer::generate(const String& path) {
+    stop_generation();
+
+    source_path = path.begins_with("file://") ? path.substr(7) : path;
+    job_tile_size = tile_size;
+    job_interval = interval;
+    job_max_thumbnails = max_thumbnails;
+    job_worker_count = worker_count;
+
+    layout = SheetLayout();
+    layout_ready.store(false);
+    next_tile.store(0);
+    processed_tiles.store(0);
+    failure_message.store(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(atlas_mutex);
+        atlas_pixels.clear();
+        new_tiles.clear();
+        finished_tile_count = 0;
+    }
+    cached_atlas.reset();
+
+    visible_layout = SheetLayout();
+    atlas_image.unref();
+    atlas_texture.unref();
+    uploading_tiles.clear();
+    visible_tiles.clear();
+    uploaded_tile_count = 0;
+    last_upload_usec = 0;
+    finish_reported = false;
+
+    cancelled.store(false);
+    state.store(STATE_GENERATING);
+    submit_job([this]() { generate_sheet(); });
+}
+
+void MPVThumbnailer::cancel() {
+    stop_generation();
+    if (state.load() == STATE_GENERATING) {
+        state.store(STATE_IDLE);
+    }
+}
+
+void MPVThumbnailer::stop_generation() {
+    cancelled.store(true);
+
+    // Jobs still queued behind other thumbnailers never start, the running ones see cancelled
+    int dropped = ThumbnailWorkers::get_singleton().cancel(this);
+    std::unique_lock<std::mutex> lock(job_mutex);
+    pending_jobs -= dropped;
+    job_cv.wait(lock, [this] { return pending_jobs == 0; });
+}
+
+void MPVThumbnailer::submit_job(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(job_mutex);
+        pending_jobs++;
+    }
+    ThumbnailWorkers::get_singleton().submit(this, [this, job = std::move(job)]() {
+        job();
+        // Notified under the lock, stop_generation() may destroy this as soon as it is released
+        std::lock_guard<std::mutex> lock(job_mutex);
+        pending_jobs--;
+        job_cv.notify_all();
+    });
+}
+
+void MPVThumbnailer::finish(int result, const char* message) {
+    // This method runs on a worker thread
+    failure_message.store(message);
+    state.store(result);
+}
+
+void MPVThumbnailer::generate_sheet() {
+    // This method runs on a worker thread, as the first job of a sheet
+    source_local = source_path.find("://") < 0 || source_path.begins_with("res://") || source_path.begins_with("user://");
+    source_size = 0;
+    source_modified_time = 0;
+
+    if (source_local) {
+        Ref<FileAccess> file = FileAccess::open(source_path, FileAccess::READ);
+        if (file.is_null()) {
+            finish(STATE_FAILED, "cannot open file");
+            return;
+        }
+        source_size = file->get_length();
+        source_modified_time = FileAccess::get_modified_time(source_path);
+
+        if (load_cache(source_size, source_modified_time)) {
+            finish(STATE_READY);
+            return;
+        }
+    }
+
+    // res:// and user:// go through the protocols registered on each decoder
+    CharString path = source_path.utf8();
+
+    auto primary = std::make_unique<HeadlessDecoder>();
+    if (!primary->open(path, cancelled)) {
+        finish(STATE_FAILED, cancelled.load() ? nullptr : "cannot load file");
+        return;
+    }
+
+    double duration = 0.0;
+    mpv_get_property(primary->mpv, "duration", MPV_FORMAT_DOUBLE, &duration);
+    if (!(duration > 0.0)) {
+        finish(STATE_FAILED, "file has no duration");
+        return;
+    }
+    if (!plan_layout(duration)) {
+        finish(STATE_FAILED, "tile size too large for a thumbnail sheet");
+        return;
+    }
+
+    // The other decoders open their own instance while the first one is already decoding, whichever
+    // finishes last wraps the sheet up
+    int decoders = std::min(job_worker_count, layout.tile_count);
+    running_decoders.store(decoders);
+    for (int i = 1; i < decoders; i++) {
+        submit_job([this]() { run_decoder(); });
+    }
+    decode_tiles(*primary);
+    primary.reset();
+    finish_decoder();
+}
+
+void MPVThumbnailer::run_decoder() {
+    // This method runs on a worker thread
+    if (!cancelled.load()) {
+        HeadlessDecoder decoder;
+        if (decoder.open(source_path.utf8(), cancelled)) {
+            decode_tiles(decoder);
+        }
+    }
+    finish_decoder();
+}
+
+void MPVThumbnailer::finish_decoder() {
+    // This method runs on a worker thread
+    if (running_decoders.fetch_sub(1) != 1) {
+        return;
+    }
+
+    if (cancelled.load()) {
+        finish(STATE_IDLE);
+        return;
+    }
+
+    int finished;
+    {
+        std::lock_guard<std::mutex> lock(atlas_mutex);
+        finished = finished_tile_count;
+    }
+    if (finished == 0) {
+        finish(STATE_FAILED, "no frame could be decoded");
+        return;
+    }
+
+    // Only complete sheets are cached, tiles that timed out get another chance next time
+    if (source_local && finished == layout.tile_count) {
+        save_cache(source_size, source_modified_time);
+    }
+    finish(STATE_READY);
+}
+
+bool MPVThumbnailer::plan_layout(double duration) {
+    // This method runs on a worker thread
+    SheetLayout planned;
+    planned.interval = std::max(job_interval, duration / job_max_thumbnails);
+    planned.tile_count = std::clamp((int)std::ceil(duration / planned.interval), 1, job_max_thumbnails);
+    planned.columns = std::min(planned.tile_count, MAX_ATLAS_SIZE / job_tile_size.x);
+
+    int max_rows = MAX_ATLAS_SIZE / job_tile_size.y;
+    if (planned.columns <= 0 || max_rows <= 0) {
+        return false;
+    }
+    if (planned.tile_count > planned.columns * max_rows) {
+        // Spread fewer tiles over the whole file rather than cutting it short
+        planned.tile_count = planned.columns * max_rows;
+        planned.interval = duration / planned.tile_count;
+    }
+    planned.rows = (planned.tile_count + planned.columns - 1) / planned.columns;
+
+    {
+        std::lock_guard<std::mutex> lock(atlas_mutex);
+        atlas_pixels.assign((size_t)planned.columns * job_tile_size.x * planned.rows * job_tile_size.y * 4, 0);
+        new_tiles.clear();
+        finished_tile_count = 0;
+    }
+    layout = planned;
+    layout_ready.store(true, std::memory_order_release);
+    return true;
+}
+
+void MPVThumbnailer::decode_tiles(HeadlessDecoder& decoder) {
+    // This method runs on a worker thread
+    std::vector<uint8_t> tile((size_t)job_tile_size.x * job_tile_size.y * 4);
+
+    while (!cancelled.load()) {
+        int index = next_tile.fetch_add(1);
+        if (index >= layout.tile_count) {
+            break;
+        }
+
+        if (decoder.render_at(index * layout.interval, job_tile_size, tile.data(), cancelled)) {
+            store_tile(index, tile.data());
+        }
+        processed_tiles.fetch_add(1);
+    }
+}
+
+void MPVThumbnailer::store_tile(int index, const uint8_t* pixels) {
+    // This method runs on a worker thread
+    size_t row_bytes = (size_t)job_tile_size.x * 4;
+    size_t atlas_stride = (size_t)layout.columns * row_bytes;
+    size_t x = (size_t)(index % layout.columns) * row_bytes;
+    size_t y = (size_t)(index / layout.columns) * job_tile_size.y;
+
+    // Nobody else touches this tile's rows until its index is published below
+    for (int row = 0; row < job_tile_size.y; row++) {
+        memcpy(atlas_pixels.data() + (y + row) * atlas_stride + x, pixels + row * row_bytes, row_bytes);
+    }
+
+    std::lock_guard<std::mutex> lock(atlas_mutex);
+    new_tiles.push_back(index);
+    finished_tile_count++;
+}
+
+void MPVThumbnailer::_process(double) {
+    // This method runs on the main thread
+    int current = state.load();
+    if (current == STATE_IDLE || !layout_ready.load(std::memory_order_acquire)) {
+        if (current == STATE_FAILED && !finish_reported) {
+            stop_generation();
+            finish_reported = true;
+            const char* message = failure_message.load();
+            emit_signal("thumbnails_failed", String(message ? message : "failed"));
+        }
+        return;
+    }
+
+    bool finished = current != STATE_GENERATING;
+    if (finished && finish_reported) {
+        return;
+    }
+
+    uint64_t now = Time::get_singleton()->get_ticks_usec();
+    if (!finished && now - last_upload_usec < UPLOAD_INTERVAL_USEC) {
+        return;
+    }
+    last_upload_usec = now;
+
+    if (finished) {
+        stop_generation();
+    }
+    upload_atlas(finished);
+
+    if (finished) {
+        finish_reported = true;
+        if (current == STATE_READY) {
+            emit_signal("thumbnails_ready");
+        } else if (current == STATE_FAILED) {
+            const char* message = failure_message.load();
+            emit_signal("thumbnails_failed", String(message ? message : "failed"));
+        }
+    }
+}
+
+void MPVThumbnailer::upload_atlas(bool finished) {
+    // This method runs on the main thread
+    if (visible_layout.tile_count == 0) {
+        visible_layout = layout;
+        visible_tiles.assign(visible_layout.tile_count, 0);
+    }
+
+    // Every texture update sends the whole atlas to the GPU, so new tiles go up a row at a time
+    uploading_tiles.clear();
+    {
+        std::lock_guard<std::mutex> lock(atlas_mutex);
+        if (new_tiles.empty() || (!finished && (int)new_tiles.size() < visible_layout.columns)) {
+            return;
+        }
+        uploading_tiles.swap(new_tiles);
+    }
+
+    if (atlas_image.is_null()) {
+        int atlas_width = visible_layout.columns * job_tile_size.x;
+        int atlas_height = visible_layout.rows * job_tile_size.y;
+        atlas_image = Image::create_empty(atlas_width, atlas_height, false, Image::FORMAT_RGBA8);
+    }
+    if (cached_atlas) {
+        // Straight from the mapped file, which isn't needed afterwards
+        size_t pixel_bytes = (size_t)atlas_image->get_width() * atlas_image->get_height() * 4;
+        memcpy(atlas_image->ptrw(), cached_atlas->get_mapped_data() + CACHE_HEADER_SIZE, pixel_bytes);
+        cached_atlas.reset();
+    } else if ((int)uploading_tiles.size() == visible_layout.tile_count) {
+        // Every tile arrived between two uploads
+        memcpy(atlas_image->ptrw(), atlas_pixels.data(), atlas_pixels.size());
+    } else {
+        for (int index : uploading_tiles) {
+            blit_tile(index);
+        }
+    }
+
+    if (atlas_texture.is_null()) {
+        atlas_texture = ImageTexture::create_from_image(atlas_image);
+    } else {
+        atlas_texture->update(atlas_image);
+    }
+
+    for (int index : uploading_tiles) {
+        visible_tiles[index] = 1;
+    }
+    uploaded_tile_count += (int)uploading_tiles.size();
+    emit_signal("thumbnails_progress", uploaded_tile_count, visible_layout.tile_count);
+}
+
+void MPVThumbnailer::blit_tile(int index) {
+    // This method runs on the main thread
+    size_t row_bytes = (size_t)job_tile_size.x * 4;
+    size_t atlas_stride = (size_t)visible_layout.columns * row_bytes;
+    size_t offset = (size_t)(index / visible_layout.columns) * job_tile_size.y * atlas_stride +
+        (size_t)(index % visible_layout.columns) * row_bytes;
+
+    uint8_t* dst = atlas_image->ptrw() + offset;
+    const uint8_t* src = atlas_pixels.data() + offset;
+    for (int row = 0; row < job_tile_size.y; row++) {
+        memcpy(dst + row * atlas_stride, src + row * atlas_stride, row_bytes);
+    }
+}
+
+bool MPVThumbnailer::is_ready() const {
+    return finish_reported && state.load() == STATE_READY;
+}
+
+double MPVThumbnailer::get_progress() const {
+    if (!layout_ready.load(std::memory_order_acquire) || layout.tile_count == 0) {
+        return 0.0;
+    }
+    return std::min((double)processed_tiles.load() / layout.tile_count, 1.0);
+}
+
+int MPVThumbnailer::get_thumbnail_count() const {
+    return visible_layout.tile_count;
+}
+
+double MPVThumbnailer::get_thumbnail_interval() const {
+    return visible_layout.interval;
+}
+
+Ref<Texture2D> MPVThumbnailer::get_atlas_texture() const {
+    return atlas_texture;
+}
+
+Rect2 MPVThumbnailer::get_thumbnail(double time) const {
+    if (visible_layout.tile_count == 0 || atlas_texture.is_null()) {
+        return Rect2();
+    }
+
+    int index = std::clamp((int)std::floor(time / visible_layout.interval), 0, visible_layout.tile_count - 1);
+    if (!visible_tiles[index]) {
+        return Rect2();
+    }
+
+    int column = index % visible_layout.columns;
+    int row = index / visible_layout.columns;
+    return Rect2(column * job_tile_size.x, row * job_tile_size.y, job_tile_size.x, job_tile_size.y);
+}
+
+// ==================== Cache ====================
+
+// Layout: a little-endian header padded to CACHE_HEADER_SIZE, then the atlas as raw RGBA8 rows.
+// The key covers everything that changes the result, the header repeats it so a hash
+// collision or a stale file is never used.
+
+String MPVThumbnailer::get_cache_path() const {
+    String key = source_path + "|" + String::num_int64(job_tile_size.x) + "x" + String::num_int64(job_tile_size.y) + "|" +
+        String::num(job_interval, 3) + "|" + String::num_int64(job_max_thumbnails);
+    return String(CACHE_DIR) + "/" + key.md5_text() + ".mpvthumb";
+}
+
+bool MPVThumbnailer::load_cache(uint64_t size, uint64_t modified_time) {
+    // This method runs on a worker thread. The file is mapped rather than read: user:// files are
+    // otherwise never mapped since another writer could truncate them under the mapping, but
+    // save_cache() only ever replaces a sheet by renaming a new file over it.
+    String os_path = ProjectSettings::get_singleton()->globalize_path(get_cache_path());
+    std::unique_ptr<GodotStream> file(GodotStream::map_file(os_path));
+    if (!file || (uint64_t)file->get_size() < CACHE_HEADER_SIZE) {
+        return false;
+    }
+
+    // Written by FileAccess, little-endian
+    const uint8_t* header = file->get_mapped_data();
+    size_t offset = 0;
+    auto get_32 = [header, &offset]() {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++) {
+            value |= (uint32_t)header[offset++] << (8 * i);
+        }
+        return value;
+    };
+    auto get_64 = [&get_32]() {
+        uint64_t low = get_32();
+        return low | (uint64_t)get_32() << 32;
+    };
+
+    if (get_32() != CACHE_MAGIC || get_32() != CACHE_VERSION || get_64() != size || get_64() != modified_time) {
+        return false;
+    }
+    if ((int)get_32() != job_tile_size.x || (int)get_32() != job_tile_size.y) {
+        return false;
+    }
+
+    SheetLayout cached;
+    uint64_t interval_bits = get_64();
+    memcpy(&cached.interval, &interval_bits, sizeof(double));
+    cached.tile_count = (int)get_32();
+    cached.columns = (int)get_32();
+    cached.rows = (int)get_32();
+    if (!(cached.interval > 0.0) || cached.tile_count <= 0 || cached.columns <= 0 || cached.rows <= 0 ||
+        cached.columns * job_tile_size.x > MAX_ATLAS_SIZE || cached.rows * job_tile_size.y > MAX_ATLAS_SIZE ||
+        cached.tile_count > cached.columns * cached.rows) {
+        return false;
+    }
+
+    size_t pixel_bytes = (size_t)cached.columns * job_tile_size.x * cached.rows * job_tile_size.y * 4;
+    if ((uint64_t)file->get_size() != CACHE_HEADER_SIZE + pixel_bytes) {
+        return false;
+    }
+
+    cached_atlas = std::move(file);
+    {
+        std::lock_guard<std::mutex> lock(atlas_mutex);
+        new_tiles.resize(cached.tile_count);
+        for (int i = 0; i < cached.tile_count; i++) {
+            new_tiles[i] = i;
+        }
+        finished_tile_count = cached.tile_count;
+    }
+
+    layout = cached;
+    processed_tiles.store(cached.tile_count);
+    layout_ready.store(true, std::memory_order_release);
+    return true;
+}
+
+void MPVThumbnailer::save_cache(uint64_t size, uint64_t modified_time) {
+    // This method runs on a worker thread, after every decoder has finished
+    DirAccess::make_dir_recursive_absolute(CACHE_DIR);
+    Ref<FileAccess> file = FileAccess::open(get_cache_path(), FileAccess::WRITE);
+    if (file.is_null()) {
+        return;
+    }
+
+    file->store_32(CACHE_MAGIC);
+    file->store_32(CACHE_VERSION);
+    file->store_64(size);
+    file->store_64(modified_time);
+    file->store_32((uint32_t)job_tile_size.x);
+    file->store_32((uint32_t)job_tile_size.y);
+    file->store_double(layout.interval);
+    file->store_32((uint32_t)layout.tile_count);
+    file->store_32((uint32_t)layout.columns);
+    file->store_32((uint32_t)layout.rows);
+
+    std::vector<uint8_t> padding(CACHE_HEADER_SIZE - file->get_position(), 0);
+    file->store_buffer(padding.data(), padding.size());
+    file->store_buffer(atlas_pixels.data(), atlas_pixels.size());
+}
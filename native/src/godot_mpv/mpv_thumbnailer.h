@@ -0,0 +1,147 @@
+#ifndef MPV_THUMBNAILER_H
+#define MPV_THUMBNAILER_H
+
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/image_texture.hpp>
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/rect2.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace godot;
+
+class GodotStream;
+
+// Seek-preview storyboard for a scrub bar: one frame every interval seconds, downscaled into a
+// single atlas texture. Frames come from headless mpv instances using the software render API
+// (no GL context, no audio, keyframe seeks) on a pool of worker threads shared by every
+// thumbnailer. The finished
+// sheet is cached under user://thumbnails in a page-aligned raw layout, keyed by path, size and
+// modification time, so reopening a file shows its thumbnails without decoding anything.
+class MPVThumbnailer : public Node {
+    GDCLASS(MPVThumbnailer, Node);
+
+private:
+    struct HeadlessDecoder;
+
+    enum State : int {
+        STATE_IDLE,
+        STATE_GENERATING,
+        STATE_READY,
+        STATE_FAILED
+    };
+
+    // Fixed by the first job once it knows the duration, or read from the cache
+    struct SheetLayout {
+        double interval = 0.0; // Effective spacing, widened to stay within max_thumbnails
+        int tile_count = 0;
+        int columns = 0;
+        int rows = 0;
+    };
+
+    // Settings, copied when generate() starts
+    double interval = 10.0;
+    Vector2i tile_size = Vector2i(160, 90);
+    int max_thumbnails = 300;
+    int worker_count = 2;
+
+    // Shared with the jobs running on the worker pool
+    String source_path;
+    Vector2i job_tile_size;
+    double job_interval = 0.0;
+    int job_max_thumbnails = 0;
+    int job_worker_count = 0;
+    bool source_local = false;
+    uint64_t source_size = 0;
+    uint64_t source_modified_time = 0;
+    std::mutex job_mutex;
+    std::condition_variable job_cv;
+    int pending_jobs = 0; // Queued or running, guarded by job_mutex
+    std::atomic<int> running_decoders{0};
+    std::atomic<bool> cancelled{false};
+    std::atomic<int> state{STATE_IDLE};
+    std::atomic<const char*> failure_message{nullptr};
+    std::atomic<bool> layout_ready{false};
+    SheetLayout layout; // Written before layout_ready is set
+    std::atomic<int> next_tile{0};
+    std::atomic<int> processed_tiles{0};
+    std::mutex atlas_mutex;
+    // RGBA8, sized before layout_ready is set. A tile's pixels are written once, before its index
+    // is added to new_tiles, so the main thread reads them without the lock.
+    std::vector<uint8_t> atlas_pixels;
+    std::vector<int> new_tiles; // Finished but not uploaded yet, guarded by atlas_mutex
+    std::unique_ptr<GodotStream> cached_atlas; // Mapped cache file, used instead of atlas_pixels
+    int finished_tile_count = 0; // Guarded by atlas_mutex
+
+    // Main thread
+    SheetLayout visible_layout;
+    Ref<Image> atlas_image;
+    Ref<ImageTexture> atlas_texture;
+    std::vector<int> uploading_tiles;
+    std::vector<uint8_t> visible_tiles; // Tiles already uploaded to atlas_texture
+    int uploaded_tile_count = 0;
+    uint64_t last_upload_usec = 0;
+    bool finish_reported = false;
+
+    void submit_job(std::function<void()> job);
+    void generate_sheet();
+    void run_decoder();
+    void finish_decoder();
+    void finish(int result, const char* message = nullptr);
+    bool plan_layout(double duration);
+    void decode_tiles(HeadlessDecoder& decoder);
+    void store_tile(int index, const uint8_t* pixels);
+    String get_cache_path() const;
+    bool load_cache(uint64_t size, uint64_t modified_time);
+    void save_cache(uint64_t size, uint64_t modified_time);
+    void upload_atlas(bool finished);
+    void blit_tile(int index);
+    void stop_generation();
+
+protected:
+    static void _bind_methods();
+
+public:
+    MPVThumbnailer();
+    ~MPVThumbnailer();
+
+    virtual void _process(double delta) override;
+
+    // Spacing of the thumbnails in seconds, widened for long files to stay within max_thumbnails
+    void set_interval(double seconds);
+    double get_interval() const;
+    void set_tile_size(Vector2i size);
+    Vector2i get_tile_size() const;
+    void set_max_thumbnails(int count);
+    int get_max_thumbnails() const;
+    // Headless mpv instances decoding in parallel for one sheet. At most as many run at once as the
+    // shared worker pool has threads, across every thumbnailer.
+    void set_worker_count(int count);
+    int get_worker_count() const;
+
+    // Start building (or loading from the cache) the sheet for a file, replacing the previous one.
+    // thumbnails_progress(done, total) follows as tiles become available, then thumbnails_ready()
+    // or thumbnails_failed().
+    void generate(const String& path);
+    void cancel();
+
+    bool is_ready() const;
+    double get_progress() const;
+    int get_thumbnail_count() const;
+    double get_thumbnail_interval() const;
+
+    // Texture holding every thumbnail, null until the first tiles are uploaded
+    Ref<Texture2D> get_atlas_texture() const;
+
+    // Region of the atlas showing the frame for time, empty while that tile isn't available
+    Rect2 get_thumbnail(double time) const;
+};
+
+#endif // MPV_THUMBNAILER_H
@@ -0,0 +1,114 @@
+#include "player_reaper.h"
+#include "egl_display_manager.h"
+
+#include <godot_cpp/variant/utility_functions.hpp>
+
+using namespace godot;
+
+PlayerReaper& PlayerReaper::get_singleton() {
+    static PlayerReaper instance;
+    return instance;
+}
+
+void PlayerReaper::reap(PlayerResources&& resources) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!stopped) {
+            if (!thread.joinable()) {
+                thread = std::thread(&PlayerReaper::run, this);
+            }
+            queue.push_back(std::move(resources));
+            cv.notify_one();
+            return;
+        }
+    }
+
+    // The extension is unloading, nothing may outlive it
+    destroy(resources);
+}
+
+void PlayerReaper::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        stopped = true;
+    }
+    cv.notify_one();
+
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void PlayerReaper::run() {
+    while (true) {
+        PlayerResources resources;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return stopping || !queue.empty(); });
+
+            // Drain the queue before honouring a stop request
+            if (queue.empty()) {
+                break;
+            }
+            resources = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        destroy(resources);
+    }
+}
+
+void PlayerReaper::destroy(PlayerResources& resources) {
+    // The render context and GL objects need the player's context current on this thread
+    bool context_current = !resources.uses_gl;
+    #ifndef __APPLE__
+    if (resources.uses_gl && resources.egl_context != EGL_NO_CONTEXT) {
+        context_current = eglMakeCurrent(resources.egl_display, resources.egl_surface,
+            resources.egl_surface, resources.egl_context) == EGL_TRUE;
+    }
+    #else
+    context_current = true;
+    #endif
+
+    if (context_current) {
+        // Must go before mpv_terminate_destroy
+        if (resources.render_context) {
+            mpv_render_context_free(resources.render_context);
+        }
+
+        if (resources.uses_gl) {
+            for (GLsync fence : resources.fences) {
+                glDeleteSync(fence);
+            }
+            if (!resources.buffers.empty()) {
+                glDeleteBuffers((GLsizei)resources.buffers.size(), resources.buffers.data());
+            }
+            if (resources.fbo != 0) {
+                glDeleteFramebuffers(1, &resources.fbo);
+            }
+            if (resources.texture != 0) {
+                glDeleteTextures(1, &resources.texture);
+            }
+        }
+    } else {
+        // Still current on another thread. The context itself is destroyed below regardless, EGL
+        // frees it once that thread lets go of it.
+        UtilityFunctions::print("ERROR: Could not make a deleted player's GL context current, leaking its render context and GL objects");
+    }
+
+    #ifndef __APPLE__
+    // Only this player's context goes away, the display is shared with the other players
+    if (resources.egl_display != EGL_NO_DISPLAY) {
+        eglMakeCurrent(resources.egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+        EGLDisplayManager& egl = EGLDisplayManager::get_singleton();
+        egl.destroy_context(resources.egl_context, resources.egl_surface);
+        egl.release();
+    }
+    #endif
+
+    if (resources.mpv) {
+        mpv_terminate_destroy(resources.mpv);
+    }
+}
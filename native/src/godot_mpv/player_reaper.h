@@ -0,0 +1,68 @@
+#ifndef PLAYER_REAPER_H
+#define PLAYER_REAPER_H
+
+#include <mpv/client.h>
+#include <mpv/render_gl.h>
+
+#ifndef __APPLE__
+#include <EGL/egl.h>
+#include <glad/gles2.h>
+#else
+#include <OpenGL/gl3.h>
+#endif
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Everything a deleted MPVPlayer leaves behind. The player's threads are already stopped
+// and no GL context is current anywhere when this is handed over.
+struct PlayerResources {
+    mpv_handle* mpv = nullptr;
+    mpv_render_context* render_context = nullptr;
+    bool uses_gl = false;
+
+    #ifndef __APPLE__
+    EGLDisplay egl_display = EGL_NO_DISPLAY;
+    EGLSurface egl_surface = EGL_NO_SURFACE;
+    EGLContext egl_context = EGL_NO_CONTEXT;
+    #endif
+
+    GLuint fbo = 0;
+    GLuint texture = 0;
+    std::vector<GLuint> buffers;
+    std::vector<GLsync> fences;
+};
+
+// Destroys deleted players on a background thread.
+// mpv_render_context_free and mpv_terminate_destroy wait for the video output, demuxer and
+// network threads to exit, which for a stream can take up to the network timeout. Doing it
+// here lets queue_free() of a player return immediately.
+class PlayerReaper {
+public:
+    static PlayerReaper& get_singleton();
+
+    // Take ownership of a player's resources, the thread is started on first use
+    void reap(PlayerResources&& resources);
+
+    // Finish every queued teardown and stop the thread, called when the extension unloads.
+    // Players deleted afterwards are destroyed on the calling thread.
+    void shutdown();
+
+private:
+    PlayerReaper() = default;
+
+    void run();
+    static void destroy(PlayerResources& resources);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<PlayerResources> queue; // Guarded by mutex
+    std::thread thread;
+    bool stopping = false;
+    bool stopped = false;
+};
+
+#endif // PLAYER_REAPER_H
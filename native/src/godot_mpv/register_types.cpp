@@ -4,23 +4,46 @@
 #include <godot_cpp/core/defs.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/godot.hpp>
+#include <godot_cpp/classes/engine.hpp>
 
 #include "mpv_player.h"
+#include "mpv_player_pool.h"
+#include "mpv_thumbnailer.h"
+#include "player_reaper.h"
+#include "thumbnail_workers.h"
 
 using namespace godot;
 
+static MPVPlayerPool* player_pool = nullptr;
+
 void initialize_godot_mpv_module(ModuleInitializationLevel p_level) {
     if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
         return;
     }
 
     ClassDB::register_class<MPVPlayer>();
+    ClassDB::register_class<MPVPlayerPool>();
+    ClassDB::register_class<MPVThumbnailer>();
+
+    player_pool = memnew(MPVPlayerPool);
+    Engine::get_singleton()->register_singleton("MPVPlayerPool", player_pool);
 }
 
 void uninitialize_godot_mpv_module(ModuleInitializationLevel p_level) {
     if (p_level != MODULE_INITIALIZATION_LEVEL_SCENE) {
         return;
     }
+
+    // Pooled players go to the reaper like any other deleted player
+    Engine::get_singleton()->unregister_singleton("MPVPlayerPool");
+    memdelete(player_pool);
+    player_pool = nullptr;
+
+    // Thumbnail decoders hand their mpv instances to the reaper too
+    ThumbnailWorkers::get_singleton().shutdown();
+
+    // Finish destroying deleted players before the library goes away
+    PlayerReaper::get_singleton().shutdown();
 }
 
 extern "C" {
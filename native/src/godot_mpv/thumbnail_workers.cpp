@@ -0,0 +1,116 @@
+#include "thumbnail_workers.h"
+
+#include <algorithm>
+
+// Each instance already decodes on a couple of threads of its own
+static const int MAX_THREADS = 4;
+
+ThumbnailWorkers& ThumbnailWorkers::get_singleton() {
+    static ThumbnailWorkers instance;
+    return instance;
+}
+
+int ThumbnailWorkers::get_thread_count() const {
+    return std::clamp((int)std::thread::hardware_concurrency() / 2, 1, MAX_THREADS);
+}
+
+void ThumbnailWorkers::submit(const void* owner, std::function<void()> job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stopping) {
+        return;
+    }
+
+    queue.push_back({owner, std::move(job)});
+    if (idle_threads == 0 && (int)threads.size() < get_thread_count()) {
+        threads.emplace_back(&ThumbnailWorkers::run, this);
+    } else {
+        cv.notify_one();
+    }
+}
+
+int ThumbnailWorkers::cancel(const void* owner) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto end = std::remove_if(queue.begin(), queue.end(), [owner](const Job& job) { return job.owner == owner; });
+    int dropped = (int)(queue.end() - end);
+    queue.erase(end, queue.end());
+    return dropped;
+}
+
+void ThumbnailWorkers::run_on_render_thread(const std::function<void()>& call) {
+    std::unique_lock<std::mutex> lock(render_mutex);
+    if (render_stopping) {
+        return;
+    }
+    if (!render_thread.joinable()) {
+        render_thread = std::thread(&ThumbnailWorkers::run_render, this);
+    }
+
+    render_calls.push_back(&call);
+    uint64_t ticket = ++render_calls_queued;
+    render_cv.notify_all();
+    render_cv.wait(lock, [this, ticket] { return render_calls_done >= ticket; });
+}
+
+void ThumbnailWorkers::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        queue.clear();
+    }
+    cv.notify_all();
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+
+    // Only now, running jobs may still have been waiting on a render call
+    {
+        std::lock_guard<std::mutex> lock(render_mutex);
+        render_stopping = true;
+    }
+    render_cv.notify_all();
+    if (render_thread.joinable()) {
+        render_thread.join();
+    }
+}
+
+void ThumbnailWorkers::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        idle_threads++;
+        cv.wait(lock, [this] { return stopping || !queue.empty(); });
+        idle_threads--;
+        if (stopping) {
+            break;
+        }
+
+        Job job = std::move(queue.front());
+        queue.pop_front();
+
+        lock.unlock();
+        job.run();
+        lock.lock();
+    }
+}
+
+void ThumbnailWorkers::run_render() {
+    std::unique_lock<std::mutex> lock(render_mutex);
+    while (true) {
+        render_cv.wait(lock, [this] { return render_stopping || !render_calls.empty(); });
+        if (render_calls.empty()) {
+            break;
+        }
+
+        // Calls are answered in the order they were queued, so the count tells each caller it's done
+        const std::function<void()>* call = render_calls.front();
+        render_calls.pop_front();
+
+        lock.unlock();
+        (*call)();
+        lock.lock();
+
+        render_calls_done++;
+        render_cv.notify_all();
+    }
+}
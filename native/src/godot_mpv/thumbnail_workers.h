@@ -0,0 +1,62 @@
+#ifndef THUMBNAIL_WORKERS_H
+#define THUMBNAIL_WORKERS_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Threads shared by every MPVThumbnailer. Each job drives one headless mpv instance through the
+// client API, so the number of threads also caps how many instances decode at once, however many
+// thumbnailers are generating. Calls into their render contexts all go to one separate render
+// thread, which makes no client API calls.
+class ThumbnailWorkers {
+public:
+    static ThumbnailWorkers& get_singleton();
+
+    // Queue a job on behalf of owner, threads are started on first use up to the fixed cap
+    void submit(const void* owner, std::function<void()> job);
+
+    // Drop owner's jobs that haven't started yet, returns how many were dropped
+    int cancel(const void* owner);
+
+    int get_thread_count() const;
+
+    // Run call on the render thread and wait for it to return
+    void run_on_render_thread(const std::function<void()>& call);
+
+    // Stop the threads once the running jobs are done, called when the extension unloads.
+    // Jobs still queued are dropped.
+    void shutdown();
+
+private:
+    ThumbnailWorkers() = default;
+
+    void run();
+    void run_render();
+
+    struct Job {
+        const void* owner = nullptr;
+        std::function<void()> run;
+    };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Job> queue; // Guarded by mutex
+    std::vector<std::thread> threads;
+    int idle_threads = 0; // Guarded by mutex
+    bool stopping = false;
+
+    std::mutex render_mutex;
+    std::condition_variable render_cv;
+    std::deque<const std::function<void()>*> render_calls; // Guarded by render_mutex
+    uint64_t render_calls_done = 0; // Guarded by render_mutex
+    uint64_t render_calls_queued = 0; // Guarded by render_mutex
+    std::thread render_thread;
+    bool render_stopping = false;
+};
+
+#endif // THUMBNAIL_WORKERS_H